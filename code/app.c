@@ -5,6 +5,10 @@
 #include <unistd.h>
 #include <time.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <stdint.h>
 #include <errno.h>
 
 // === smart_clock 드라이버 데이터 구조체 ===
@@ -15,63 +19,334 @@ typedef struct {
     int mode; // 0:Normal, 1:Set Hour, 2:Set Min
 } clock_info_t;
 
+// === my_oled 드라이버 인터페이스 (oled_rect_t, OLED_IOC_*: 드라이버와 같은 헤더 사용) ===
+#include "oled_ssd1306.h"
+
 // === (추가) DHT11 드라이버 데이터 구조체 (바이너리로 줄 때 대비) ===
 typedef struct {
     int hum;   // 습도
     int temp;  // 온도
 } dht11_info_t;
 
-// === 폰트 데이터 ===
-const unsigned char font5x7[][5] = {
-    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0 (index 0)
-    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
-    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
-    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
-    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
-    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
-    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
-    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
-    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
-    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
-    {0x08, 0x08, 0x08, 0x08, 0x08}, // - (index 10)
-    {0x00, 0x36, 0x36, 0x00, 0x00}, // : (index 11)
-    {0x00, 0x00, 0x00, 0x00, 0x00}, // space (index 12)
-    {0x3E, 0x41, 0x41, 0x41, 0x22}, // [ (index 13)
-    {0x22, 0x41, 0x41, 0x41, 0x3E}, // ] (index 14)
-    {0x00, 0x00, 0x00, 0x00, 0x00}  // safety
+// === 폰트 데이터 (컴파일 타임 생성 글리프 아틀라스) ===
+// 컬럼 단위 세로 비트맵 (bit0 = 맨 위 픽셀) → SSD1306 페이지 바이트와 같은 배치라 그대로 복사 가능
+
+// 5x7 글리프 한 칸 = 5컬럼 + 간격 1컬럼
+#define G(...)  G_(__VA_ARGS__)
+#define G_(a, b, c, d, e) { a, b, c, d, e, 0x00 }
+
+// 숫자/기호는 큰 폰트에서도 같은 모양을 쓰므로 따로 정의
+#define GLYPH_0      0x3E, 0x51, 0x49, 0x45, 0x3E
+#define GLYPH_1      0x00, 0x42, 0x7F, 0x40, 0x00
+#define GLYPH_2      0x42, 0x61, 0x51, 0x49, 0x46
+#define GLYPH_3      0x21, 0x41, 0x45, 0x4B, 0x31
+#define GLYPH_4      0x18, 0x14, 0x12, 0x7F, 0x10
+#define GLYPH_5      0x27, 0x45, 0x45, 0x45, 0x39
+#define GLYPH_6      0x3C, 0x4A, 0x49, 0x49, 0x30
+#define GLYPH_7      0x01, 0x71, 0x09, 0x05, 0x03
+#define GLYPH_8      0x36, 0x49, 0x49, 0x49, 0x36
+#define GLYPH_9      0x06, 0x49, 0x49, 0x29, 0x1E
+#define GLYPH_COLON  0x00, 0x36, 0x36, 0x00, 0x00
+#define GLYPH_MINUS  0x08, 0x08, 0x08, 0x08, 0x08
+
+// ASCII 전체 직접 조회 테이블 (정의 안 된 문자는 공백)
+const unsigned char glyph_atlas[256][6] = {
+    [' ']  = G(0x00, 0x00, 0x00, 0x00, 0x00),
+    ['!']  = G(0x00, 0x00, 0x5F, 0x00, 0x00),
+    ['"']  = G(0x00, 0x07, 0x00, 0x07, 0x00),
+    ['#']  = G(0x14, 0x7F, 0x14, 0x7F, 0x14),
+    ['$']  = G(0x24, 0x2A, 0x7F, 0x2A, 0x12),
+    ['%']  = G(0x23, 0x13, 0x08, 0x64, 0x62),
+    ['&']  = G(0x36, 0x49, 0x55, 0x22, 0x50),
+    ['\''] = G(0x00, 0x05, 0x03, 0x00, 0x00),
+    ['(']  = G(0x00, 0x1C, 0x22, 0x41, 0x00),
+    [')']  = G(0x00, 0x41, 0x22, 0x1C, 0x00),
+    ['*']  = G(0x08, 0x2A, 0x1C, 0x2A, 0x08),
+    ['+']  = G(0x08, 0x08, 0x3E, 0x08, 0x08),
+    [',']  = G(0x00, 0x50, 0x30, 0x00, 0x00),
+    ['-']  = G(GLYPH_MINUS),
+    ['.']  = G(0x00, 0x60, 0x60, 0x00, 0x00),
+    ['/']  = G(0x20, 0x10, 0x08, 0x04, 0x02),
+    ['0']  = G(GLYPH_0),
+    ['1']  = G(GLYPH_1),
+    ['2']  = G(GLYPH_2),
+    ['3']  = G(GLYPH_3),
+    ['4']  = G(GLYPH_4),
+    ['5']  = G(GLYPH_5),
+    ['6']  = G(GLYPH_6),
+    ['7']  = G(GLYPH_7),
+    ['8']  = G(GLYPH_8),
+    ['9']  = G(GLYPH_9),
+    [':']  = G(GLYPH_COLON),
+    [';']  = G(0x00, 0x56, 0x36, 0x00, 0x00),
+    ['<']  = G(0x00, 0x08, 0x14, 0x22, 0x41),
+    ['=']  = G(0x14, 0x14, 0x14, 0x14, 0x14),
+    ['>']  = G(0x41, 0x22, 0x14, 0x08, 0x00),
+    ['?']  = G(0x02, 0x01, 0x51, 0x09, 0x06),
+    ['@']  = G(0x32, 0x49, 0x79, 0x41, 0x3E),
+    ['A']  = G(0x7E, 0x11, 0x11, 0x11, 0x7E),
+    ['B']  = G(0x7F, 0x49, 0x49, 0x49, 0x36),
+    ['C']  = G(0x3E, 0x41, 0x41, 0x41, 0x22),
+    ['D']  = G(0x7F, 0x41, 0x41, 0x22, 0x1C),
+    ['E']  = G(0x7F, 0x49, 0x49, 0x49, 0x41),
+    ['F']  = G(0x7F, 0x09, 0x09, 0x01, 0x01),
+    ['G']  = G(0x3E, 0x41, 0x41, 0x51, 0x32),
+    ['H']  = G(0x7F, 0x08, 0x08, 0x08, 0x7F),
+    ['I']  = G(0x00, 0x41, 0x7F, 0x41, 0x00),
+    ['J']  = G(0x20, 0x40, 0x41, 0x3F, 0x01),
+    ['K']  = G(0x7F, 0x08, 0x14, 0x22, 0x41),
+    ['L']  = G(0x7F, 0x40, 0x40, 0x40, 0x40),
+    ['M']  = G(0x7F, 0x02, 0x04, 0x02, 0x7F),
+    ['N']  = G(0x7F, 0x04, 0x08, 0x10, 0x7F),
+    ['O']  = G(0x3E, 0x41, 0x41, 0x41, 0x3E),
+    ['P']  = G(0x7F, 0x09, 0x09, 0x09, 0x06),
+    ['Q']  = G(0x3E, 0x41, 0x51, 0x21, 0x5E),
+    ['R']  = G(0x7F, 0x09, 0x19, 0x29, 0x46),
+    ['S']  = G(0x46, 0x49, 0x49, 0x49, 0x31),
+    ['T']  = G(0x01, 0x01, 0x7F, 0x01, 0x01),
+    ['U']  = G(0x3F, 0x40, 0x40, 0x40, 0x3F),
+    ['V']  = G(0x1F, 0x20, 0x40, 0x20, 0x1F),
+    ['W']  = G(0x7F, 0x20, 0x18, 0x20, 0x7F),
+    ['X']  = G(0x63, 0x14, 0x08, 0x14, 0x63),
+    ['Y']  = G(0x03, 0x04, 0x78, 0x04, 0x03),
+    ['Z']  = G(0x61, 0x51, 0x49, 0x45, 0x43),
+    ['[']  = G(0x00, 0x00, 0x7F, 0x41, 0x41),
+    ['\\'] = G(0x02, 0x04, 0x08, 0x10, 0x20),
+    [']']  = G(0x41, 0x41, 0x7F, 0x00, 0x00),
+    ['^']  = G(0x04, 0x02, 0x01, 0x02, 0x04),
+    ['_']  = G(0x40, 0x40, 0x40, 0x40, 0x40),
+    ['`']  = G(0x00, 0x01, 0x02, 0x04, 0x00),
+    ['a']  = G(0x20, 0x54, 0x54, 0x54, 0x78),
+    ['b']  = G(0x7F, 0x48, 0x44, 0x44, 0x38),
+    ['c']  = G(0x38, 0x44, 0x44, 0x44, 0x20),
+    ['d']  = G(0x38, 0x44, 0x44, 0x48, 0x7F),
+    ['e']  = G(0x38, 0x54, 0x54, 0x54, 0x18),
+    ['f']  = G(0x08, 0x7E, 0x09, 0x01, 0x02),
+    ['g']  = G(0x08, 0x14, 0x54, 0x54, 0x3C),
+    ['h']  = G(0x7F, 0x08, 0x04, 0x04, 0x78),
+    ['i']  = G(0x00, 0x44, 0x7D, 0x40, 0x00),
+    ['j']  = G(0x20, 0x40, 0x44, 0x3D, 0x00),
+    ['k']  = G(0x00, 0x7F, 0x10, 0x28, 0x44),
+    ['l']  = G(0x00, 0x41, 0x7F, 0x40, 0x00),
+    ['m']  = G(0x7C, 0x04, 0x18, 0x04, 0x78),
+    ['n']  = G(0x7C, 0x08, 0x04, 0x04, 0x78),
+    ['o']  = G(0x38, 0x44, 0x44, 0x44, 0x38),
+    ['p']  = G(0x7C, 0x14, 0x14, 0x14, 0x08),
+    ['q']  = G(0x08, 0x14, 0x14, 0x18, 0x7C),
+    ['r']  = G(0x7C, 0x08, 0x04, 0x04, 0x08),
+    ['s']  = G(0x48, 0x54, 0x54, 0x54, 0x20),
+    ['t']  = G(0x04, 0x3F, 0x44, 0x40, 0x20),
+    ['u']  = G(0x3C, 0x40, 0x40, 0x20, 0x7C),
+    ['v']  = G(0x1C, 0x20, 0x40, 0x20, 0x1C),
+    ['w']  = G(0x3C, 0x40, 0x30, 0x40, 0x3C),
+    ['x']  = G(0x44, 0x28, 0x10, 0x28, 0x44),
+    ['y']  = G(0x0C, 0x50, 0x50, 0x50, 0x3C),
+    ['z']  = G(0x44, 0x64, 0x54, 0x4C, 0x44),
+    ['{']  = G(0x00, 0x08, 0x36, 0x41, 0x00),
+    ['|']  = G(0x00, 0x00, 0x7F, 0x00, 0x00),
+    ['}']  = G(0x00, 0x41, 0x36, 0x08, 0x00),
+    ['~']  = G(0x08, 0x04, 0x08, 0x10, 0x08),
+};
+
+// 2배 폰트: 5x7 글리프를 가로/세로 2배로 늘린 10x14 (+ 간격 2컬럼) = 12컬럼 x 2페이지
+// 세로 2배: 원래 비트 i → 비트 2i, 2i+1 (16비트 컬럼의 아래 바이트 = 위쪽 페이지)
+#define X2_BIT(v, i) ((((v) >> (i)) & 1) * (3u << (2 * (i))))
+#define X2(v)        (X2_BIT(v, 0) | X2_BIT(v, 1) | X2_BIT(v, 2) | X2_BIT(v, 3) | \
+                      X2_BIT(v, 4) | X2_BIT(v, 5) | X2_BIT(v, 6) | X2_BIT(v, 7))
+#define X2_LO(v)     (X2(v) & 0xFF)
+#define X2_HI(v)     (X2(v) >> 8)
+
+#define G2(...) G2_(__VA_ARGS__)
+#define G2_(a, b, c, d, e) {                                         \
+    X2_LO(a), X2_LO(a), X2_LO(b), X2_LO(b), X2_LO(c), X2_LO(c),      \
+    X2_LO(d), X2_LO(d), X2_LO(e), X2_LO(e), 0x00, 0x00,              \
+    X2_HI(a), X2_HI(a), X2_HI(b), X2_HI(b), X2_HI(c), X2_HI(c),      \
+    X2_HI(d), X2_HI(d), X2_HI(e), X2_HI(e), 0x00, 0x00 }
+
+// 시계 숫자용 (페이지 순서: [위 페이지 12컬럼][아래 페이지 12컬럼])
+const unsigned char big_atlas[256][24] = {
+    ['0'] = G2(GLYPH_0),
+    ['1'] = G2(GLYPH_1),
+    ['2'] = G2(GLYPH_2),
+    ['3'] = G2(GLYPH_3),
+    ['4'] = G2(GLYPH_4),
+    ['5'] = G2(GLYPH_5),
+    ['6'] = G2(GLYPH_6),
+    ['7'] = G2(GLYPH_7),
+    ['8'] = G2(GLYPH_8),
+    ['9'] = G2(GLYPH_9),
+    [':'] = G2(GLYPH_COLON),
+    ['-'] = G2(GLYPH_MINUS),
 };
 
-// 화면 버퍼
+typedef struct {
+    const unsigned char *atlas; // 글리프 [256][pages * cell_w]
+    int cell_w;                 // 한 칸 너비 (간격 포함)
+    int glyph_w;                // 실제 글리프 너비 (간격 제외)
+    int pages;                  // 글리프 높이 (페이지 수)
+} font_t;
+
+const font_t font_small = { &glyph_atlas[0][0], 6, 5, 1 };
+const font_t font_big   = { &big_atlas[0][0], 12, 10, 2 };
+
+// 화면 버퍼 (mmap 실패 시 사용, write()로 통째로 전송)
 unsigned char buffer[1024];
 
-// 폰트 인덱스 찾기
-int get_font_index(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c == '-') return 10;
-    if (c == ':') return 11;
-    if (c == '[') return 13;
-    if (c == ']') return 14;
-    return 12; // 나머지는 공백
+// 실제로 그리는 화면: 드라이버 프레임버퍼를 mmap했으면 그 메모리, 아니면 buffer
+unsigned char *screen = buffer;
+int screen_mapped = 0;
+
+/*
+ * 블리터: 페이지 순서 비트맵(src[pages][w])을 (x, y픽셀)에 복사
+ * y가 8의 배수면 페이지마다 memcpy 한 번,
+ * 아니면 각 컬럼을 위/아래 두 페이지로 나눠서 해당 비트만 교체
+ * (화면 밖으로 나가는 부분은 잘라냄)
+ */
+void blit(const unsigned char *src, int w, int pages, int x, int y) {
+    int shift = y & 7;
+    int page0 = y >> 3;
+    int cw = w;     // 실제로 복사할 폭 (src 한 페이지의 폭 w는 그대로 stride로 사용)
+    int p, i;
+
+    if (x < 0 || x >= 128 || y < 0) return;
+    if (x + cw > 128) cw = 128 - x;
+
+    if (shift == 0) {
+        for (p = 0; p < pages && page0 + p < 8; p++)
+            memcpy(screen + (page0 + p) * 128 + x, src + p * w, cw);
+        return;
+    }
+
+    // 위 페이지는 아래쪽 (8 - shift) 비트, 다음 페이지는 위쪽 shift 비트를 차지
+    unsigned char keep_top = 0xFF >> (8 - shift);
+    unsigned char keep_bot = ~keep_top;
+
+    for (p = 0; p < pages && page0 + p < 8; p++) {
+        unsigned char *top = screen + (page0 + p) * 128 + x;
+        unsigned char *bot = top + 128;
+        const unsigned char *s = src + p * w;
+
+        for (i = 0; i < cw; i++)
+            top[i] = (top[i] & keep_top) | (unsigned char)(s[i] << shift);
+
+        if (page0 + p + 1 < 8) {
+            for (i = 0; i < cw; i++)
+                bot[i] = (bot[i] & keep_bot) | (s[i] >> (8 - shift));
+        }
+    }
+}
+
+// 글자 한 칸 그리기 (아틀라스 직접 조회 → 블리터)
+void draw_glyph(const font_t *f, int x, int y, char c) {
+    const unsigned char *g = f->atlas + (unsigned char)c * (f->pages * f->cell_w);
+    blit(g, f->cell_w, f->pages, x, y);
 }
 
-// 문자 하나 그리기
-void draw_char_5x7(int page, int col, char c) {
-    int i, font_idx = get_font_index(c);
-    int start_index = (page * 128) + col;
-    for (i = 0; i < 5; i++) {
-        if (start_index + i < 1024 && col + i < 128) {
-            buffer[start_index + i] = font5x7[font_idx][i];
+// === 위젯 (retained mode) ===
+// 각 위젯은 마지막으로 그린 문자열을 기억하고, 글자가 바뀐 칸만 다시 그림.
+// 바뀐 칸은 연속 구간마다 하나의 dirty rect로 모아서 전송 단계에 넘김
+
+#define WIDGET_MAX  24
+#define DIRTY_MAX   16
+
+typedef struct {
+    const font_t *font;        // 사용할 폰트
+    int x;                     // 시작 컬럼
+    int y;                     // 시작 y (픽셀, 페이지 경계가 아니어도 됨)
+    char text[WIDGET_MAX + 1]; // 마지막으로 그린 문자열
+    int valid;                 // 0이면 아직 한 번도 안 그림 → 전부 그림
+} widget_t;
+
+oled_rect_t dirty[DIRTY_MAX];
+int ndirty = 0;
+
+// 화면 전체를 dirty rect 하나로
+void mark_all_dirty(void) {
+    dirty[0].col = 0; dirty[0].page = 0; dirty[0].width = 128; dirty[0].pages = 8;
+    ndirty = 1;
+}
+
+// dirty rect 추가 (가득 차면 화면 전체 하나로 합침)
+void mark_dirty(int page, int pages, int col, int width) {
+    if (col + width > 128) width = 128 - col;
+    if (page + pages > 8) pages = 8 - page;
+    if (width <= 0 || pages <= 0) return;
+
+    if (ndirty == 1 && dirty[0].width == 128 && dirty[0].pages == 8) return;
+    if (ndirty == DIRTY_MAX) {
+        mark_all_dirty();
+        return;
+    }
+
+    dirty[ndirty].col = col;
+    dirty[ndirty].page = page;
+    dirty[ndirty].width = width;
+    dirty[ndirty].pages = pages;
+    ndirty++;
+}
+
+// 위젯 내용 갱신: 이전 문자열과 글자 단위로 비교해서 바뀐 칸만 그림
+void widget_set(widget_t *w, const char *text) {
+    const font_t *f = w->font;
+    int old_len = w->valid ? (int)strlen(w->text) : 0;
+    int new_len = strlen(text);
+    int len, run_start = -1;
+    int i;
+
+    if (new_len > WIDGET_MAX) new_len = WIDGET_MAX;
+    len = old_len > new_len ? old_len : new_len;
+
+    // y가 페이지 경계가 아니면 한 페이지 더 걸침
+    int page = w->y >> 3;
+    int pages = f->pages + ((w->y & 7) ? 1 : 0);
+
+    for (i = 0; i <= len; i++) {
+        // 줄어든 부분은 공백으로 지움
+        char nc = (i < new_len) ? text[i] : ' ';
+        char oc = (i < old_len) ? w->text[i] : ' ';
+        int changed = (i < len) && (!w->valid || nc != oc);
+
+        if (changed) {
+            draw_glyph(f, w->x + i * f->cell_w, w->y, nc);
+            if (run_start < 0) run_start = i;
+        } else if (run_start >= 0) {
+            // 연속으로 바뀐 칸을 rect 하나로 (마지막 칸 뒤 간격 컬럼은 항상 0이라 제외)
+            mark_dirty(page, pages, w->x + run_start * f->cell_w,
+                       (i - run_start) * f->cell_w - (f->cell_w - f->glyph_w));
+            run_start = -1;
         }
     }
+
+    memcpy(w->text, text, new_len);
+    w->text[new_len] = '\0';
+    w->valid = 1;
 }
 
-// 문자열 그리기
-void draw_string_5x7(int page, int start_col, char *str) {
-    int i = 0;
-    while (str[i] != '\0') {
-        draw_char_5x7(page, start_col + (i * 6), str[i]);
-        i++;
+// dirty rect만 OLED에 반영
+// mmap 모드: 영역별 OLED_IOC_FLUSH_RECT / 아니면 write()로 전체 (드라이버가 바뀐 바이트만 전송)
+void present(int oled_fd) {
+    int i;
+
+    if (ndirty == 0) return;
+
+    if (screen_mapped) {
+        for (i = 0; i < ndirty; i++) {
+            if (ioctl(oled_fd, OLED_IOC_FLUSH_RECT, &dirty[i]) < 0) break;
+        }
+        if (i == ndirty) {
+            ndirty = 0;
+            return;
+        }
     }
+
+    write(oled_fd, screen, 1024);
+    ndirty = 0;
+}
+
+// 디바이스 경로 (환경 변수로 바꿀 수 있음 → hw_sim 시뮬레이터에서 pty/FIFO로 대체)
+const char *dev_path(const char *env, const char *def) {
+    const char *p = getenv(env);
+    return (p && *p) ? p : def;
 }
 
 // === 시스템 시간 동기화 함수 ===
@@ -141,8 +416,50 @@ int read_dht11(int dht_fd, int *out_hum, int *out_temp) {
     return -1;
 }
 
+// 블링크(설정 모드 깜빡임) 주기
+#define BLINK_PERIOD_NS 200000000L
+
+// timerfd 만료 횟수 읽어서 비우기 (다시 readable이 되지 않도록)
+void drain_timerfd(int tfd) {
+    uint64_t expirations;
+    read(tfd, &expirations, sizeof(expirations));
+}
+
+// 깜빡임 타이머 켜기/끄기 (설정 모드일 때만 200ms 주기로 깨어남)
+void set_blink_timer(int tfd, int on) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (on) {
+        its.it_value.tv_nsec = BLINK_PERIOD_NS;
+        its.it_interval.tv_nsec = BLINK_PERIOD_NS;
+    }
+    timerfd_settime(tfd, 0, &its, NULL);
+}
+
+// 초 경계 타이머: CLOCK_REALTIME의 다음 정각 초(절대 시각)부터 1초마다
+// (윗줄 날짜는 시스템 시간 기준이라 smart_clock이 멈춘 설정 모드에서도 갱신되도록)
+void arm_second_timer(int tfd) {
+    struct itimerspec its;
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = now.tv_sec + 1;
+    its.it_interval.tv_sec = 1;
+    timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+int epoll_add(int epfd, int fd) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
 int main() {
     int oled_fd, clock_fd, dht_fd;
+    int epfd, blink_fd, sec_fd;
     clock_info_t clk_info;
 
     // 날짜 및 표시용 변수
@@ -155,63 +472,109 @@ int main() {
     char dht_str[32];
 
     // 깜빡임 제어
-    int blink_timer = 0;
     int show_text = 1;
+    int last_mode = 0;
 
-    // (추가) DHT 읽기 주기 제어/캐시
-    int dht_tick = 0;      // 0.1s 루프 기준 10번=1초
+    // (추가) DHT 측정값 캐시
     int hum = -1, temp = -1;
 
+    // 화면 위젯: 날짜(맨 위), 시간(2배 폰트, 가운데), 온습도(아래)
+    widget_t date_w = { .font = &font_small, .x = 10, .y = 0 };
+    widget_t time_w = { .font = &font_big,   .x = 16, .y = 24 };
+    widget_t dht_w  = { .font = &font_small, .x = 10, .y = 48 };
+
+    memset(&clk_info, 0, sizeof(clk_info));
+
     // 1. OLED 드라이버 열기
-    oled_fd = open("/dev/my_oled", O_WRONLY);
+    oled_fd = open(dev_path("SMARTCLOCK_OLED_DEV", "/dev/my_oled"), O_RDWR);
     if (oled_fd == -1) { perror("OLED open fail"); exit(1); }
 
+    // 드라이버 프레임버퍼를 직접 매핑 (실패하면 로컬 버퍼 + write())
+    void *fb = mmap(NULL, 1024, PROT_READ | PROT_WRITE, MAP_SHARED, oled_fd, 0);
+    if (fb != MAP_FAILED) {
+        screen = fb;
+        screen_mapped = 1;
+    }
+
+    // 시작할 때 한 번 화면 전체를 지움
+    memset(screen, 0, 1024);
+    mark_all_dirty();
+
     // 2. 시계 드라이버 열기
-    clock_fd = open("/dev/smart_clock", O_RDWR);
+    // (O_NONBLOCK: epoll이 깨운 뒤 읽고, 바뀐 게 없으면 EAGAIN)
+    clock_fd = open(dev_path("SMARTCLOCK_CLOCK_DEV", "/dev/smart_clock"), O_RDWR | O_NONBLOCK);
     if (clock_fd == -1) { perror("Clock open fail"); close(oled_fd); exit(1); }
 
     // 3. (추가) DHT11 드라이버 열기 (없어도 앱은 동작하도록 -1 처리)
-    dht_fd = open("/dev/dht11_driver", O_RDONLY);
+    // 드라이버가 새 측정값이 생길 때만 readable → 주기적으로 읽을 필요 없음
+    dht_fd = open(dev_path("SMARTCLOCK_DHT_DEV", "/dev/dht11_driver"), O_RDONLY | O_NONBLOCK);
     if (dht_fd == -1) {
         perror("DHT11 open fail (continue without DHT)");
         dht_fd = -1;
     }
 
-    // 4. 앱 시작 시 자동 시간 동기화
+    // 4. 이벤트 소스: 시계/DHT 디바이스 + 깜빡임 타이머 + 초 경계 타이머
+    epfd = epoll_create1(0);
+    blink_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    sec_fd = timerfd_create(CLOCK_REALTIME, 0);
+    if (epfd == -1 || blink_fd == -1 || sec_fd == -1) { perror("epoll/timerfd fail"); exit(1); }
+
+    epoll_add(epfd, clock_fd);
+    if (dht_fd != -1) epoll_add(epfd, dht_fd);
+    epoll_add(epfd, blink_fd);
+    epoll_add(epfd, sec_fd);
+    arm_second_timer(sec_fd);
+
+    // 5. 앱 시작 시 자동 시간 동기화
     sync_system_time(clock_fd);
 
     printf("UI Started with Auto-Sync + DHT...\n");
 
     while (1) {
-        // smart_clock 상태 읽기
-        if (read(clock_fd, &clk_info, sizeof(clock_info_t)) < 0) break;
-
-        // 윗줄 날짜용 시스템 시간 읽기
-        time(&rawtime);
-        ti = localtime(&rawtime);
-
-        // 깜빡임 타이머 (0.2초 주기)
-        blink_timer++;
-        if (blink_timer >= 2) {
-            show_text = !show_text;
-            blink_timer = 0;
+        struct epoll_event evs[4];
+        int i, n;
+
+        // 아무 일도 없으면 다음 이벤트까지 잠들어 있음 (고정 주기 폴링 없음)
+        n = epoll_wait(epfd, evs, 4, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
         }
 
-        // (추가) DHT11은 너무 자주 읽으면 실패율이 올라가서 1초에 1번만 읽고 캐시 사용
-        dht_tick++;
-        if (dht_tick >= 10) { // 0.1s * 10 = 1초
-            dht_tick = 0;
-            if (dht_fd != -1) {
+        for (i = 0; i < n; i++) {
+            int fd = evs[i].data.fd;
+
+            if (fd == clock_fd) {
+                // smart_clock 상태 읽기 (변경 없으면 EAGAIN → clk_info 그대로 사용)
+                if (read(clock_fd, &clk_info, sizeof(clock_info_t)) < 0 && errno != EAGAIN) goto out;
+            } else if (fd == dht_fd) {
                 int nh, nt;
                 if (read_dht11(dht_fd, &nh, &nt) == 0) {
                     hum = nh;
                     temp = nt;
                 }
+            } else if (fd == blink_fd) {
+                drain_timerfd(blink_fd);
+                show_text = !show_text;
+            } else if (fd == sec_fd) {
+                drain_timerfd(sec_fd);
             }
         }
 
+        // 설정 모드에 들어가거나 나올 때만 깜빡임 타이머 켜고 끔
+        if (clk_info.mode != last_mode) {
+            set_blink_timer(blink_fd, clk_info.mode != 0);
+            show_text = 1;
+            last_mode = clk_info.mode;
+        }
+
+        // 윗줄 날짜용 시스템 시간 읽기
+        time(&rawtime);
+        ti = localtime(&rawtime);
+
         // [윗줄] 날짜 고정 표시
-        sprintf(top_line_str, "%04d-%02d-%02d", ti->tm_year + 1900, ti->tm_mon + 1, ti->tm_mday);
+        strftime(top_line_str, sizeof(top_line_str), "%Y-%m-%d", ti);
 
         // [아랫줄] 시간 및 깜빡임 처리
         char hh[3], mm[3], ss[3];
@@ -224,33 +587,32 @@ int main() {
 
         sprintf(time_str, "%s:%s:%s", hh, mm, ss);
 
-        // (추가) DHT 표시 문자열 만들기
-        // 글자(H/T) 폰트가 없어서 bracket를 태그처럼 사용: [ ]HH [ ]TT
+        // (추가) DHT 표시 문자열 만들기: H:HH% T:TTC
         // 습도/온도 값 없으면 "--"
         if (hum >= 0 && temp >= 0) {
             // 습도 0~99, 온도 -9~99 정도를 가정 (필요시 더 늘려도 됨)
-            // 폰트에 '-'가 있으니 음수도 표현 가능
             char hbuf[4], tbuf[5];
             snprintf(hbuf, sizeof(hbuf), "%02d", hum);
             snprintf(tbuf, sizeof(tbuf), "%02d", temp);
-            snprintf(dht_str, sizeof(dht_str), "[ ]%s [ ]%s", hbuf, tbuf);
+            snprintf(dht_str, sizeof(dht_str), "H:%s%% T:%sC", hbuf, tbuf);
         } else {
-            snprintf(dht_str, sizeof(dht_str), "[ ]-- [ ]--");
+            snprintf(dht_str, sizeof(dht_str), "H:--%% T:--C");
         }
 
-        // 화면 그리기
-        memset(buffer, 0, 1024);
-
-        draw_string_5x7(0, 10, top_line_str); // 날짜 (page 0)
-        draw_string_5x7(2, 10, time_str);     // 시간 (page 2)
-        draw_string_5x7(4, 10, dht_str);      // (추가) 온습도 (page 4)
-
-        // OLED에 전송
-        write(oled_fd, buffer, 1024);
+        // 바뀐 글자 칸만 다시 그림 (초 하나 바뀌면 2배 폰트 한 칸 = 10컬럼 x 2페이지)
+        widget_set(&date_w, top_line_str);
+        widget_set(&time_w, time_str);
+        widget_set(&dht_w, dht_str);
 
-        usleep(100000); // 0.1초 대기
+        // 바뀐 영역만 OLED에 전송 (아무것도 안 바뀌었으면 전송 없음)
+        present(oled_fd);
     }
 
+out:
+    if (screen_mapped) munmap(screen, 1024);
+    close(sec_fd);
+    close(blink_fd);
+    close(epfd);
     if (dht_fd != -1) close(dht_fd);
     close(clock_fd);
     close(oled_fd);
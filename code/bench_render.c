@@ -0,0 +1,159 @@
+// bench_render.c
+// app.c 렌더링 경로 마이크로벤치마크 (make bench에서 사용, 결과는 JSON)
+//
+// 같은 입력(1초씩 증가하는 시계 + 온습도)으로
+//  - legacy: 예전 방식 (매 프레임 memset + font5x7 분기 조회로 모든 글자 다시 그리기)
+//  - widget: 현재 app.c 방식 (글리프 아틀라스 + 바뀐 칸만 다시 그리기 + dirty rect)
+//    legacy와 같은 화면 (5x7 폰트, 페이지 0/2/4, 컬럼 10)으로 그려서 둘을 그대로 비교
+//  - widget_app: app.c 실제 화면 (시간만 2배 폰트, y=24) - legacy와는 다른 화면이므로 비교용 아님
+// 의 프레임당 렌더 시간을 잰다. 화면 전송 비용은 hw_sim 쪽에서 측정
+
+#define main app_main
+#include "app.c"
+#undef main
+
+#define BENCH_FRAMES 20000
+
+/* ---- 예전 렌더러 (비교 기준으로 그대로 보존) ---- */
+
+static const unsigned char legacy_font5x7[][5] = {
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31},
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E},
+    {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x22, 0x41, 0x41, 0x41, 0x3E}, {0x00, 0x00, 0x00, 0x00, 0x00}
+};
+
+static unsigned char legacy_buffer[1024];
+
+static int legacy_font_index(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c == '-') return 10;
+    if (c == ':') return 11;
+    if (c == '[') return 13;
+    if (c == ']') return 14;
+    return 12;
+}
+
+static void legacy_draw_char(int page, int col, char c) {
+    int i, font_idx = legacy_font_index(c);
+    int start_index = (page * 128) + col;
+    for (i = 0; i < 5; i++) {
+        if (start_index + i < 1024 && col + i < 128)
+            legacy_buffer[start_index + i] = legacy_font5x7[font_idx][i];
+    }
+}
+
+static void legacy_draw_string(int page, int start_col, const char *str) {
+    int i = 0;
+    while (str[i] != '\0') {
+        legacy_draw_char(page, start_col + (i * 6), str[i]);
+        i++;
+    }
+}
+
+/* ---- 측정 도구 ---- */
+
+static uint64_t bench_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t pct(uint64_t *v, int n, int p) {
+    int i = (n * p + 99) / 100 - 1;
+    return v[i < 0 ? 0 : i];
+}
+
+static void print_pct(const char *name, uint64_t *v, int n, int last) {
+    qsort(v, n, sizeof(v[0]), cmp_u64);
+    printf("  \"%s\": {\"n\": %d, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s\n",
+           name, n, pct(v, n, 50) / 1000.0, pct(v, n, 90) / 1000.0,
+           pct(v, n, 99) / 1000.0, pct(v, n, 100) / 1000.0, last ? "" : ",");
+}
+
+// i번째 프레임 입력: 12:00:00부터 1초씩, 온습도는 30초마다 바뀜
+static void frame_strings(int i, char *date, char *tm, char *dht) {
+    int t = 12 * 3600 + i;
+    snprintf(date, 20, "%04d-%02d-%02d", 2024, 1, 1);
+    snprintf(tm, 20, "%02d:%02d:%02d", (t / 3600) % 24, (t / 60) % 60, t % 60);
+    snprintf(dht, 32, "H:%02d%% T:%02dC", 40 + (i / 30) % 20, 20 + (i / 30) % 10);
+}
+
+static uint64_t lat_legacy[BENCH_FRAMES], lat_widget[BENCH_FRAMES], lat_app[BENCH_FRAMES];
+
+// 위젯 세 개(날짜/시간/온습도)로 전체 프레임 렌더, 첫 프레임 뒤 평균 dirty 바이트 리턴
+static double bench_widgets(widget_t *date_w, widget_t *time_w, widget_t *dht_w, uint64_t *lat) {
+    char date[20], tm[20], dht[32];
+    uint64_t t0, dirty_bytes = 0;
+    int i, r;
+
+    memset(screen, 0, 1024);
+    ndirty = 0;
+    for (i = 0; i < BENCH_FRAMES; i++) {
+        frame_strings(i, date, tm, dht);
+
+        t0 = bench_ns();
+        widget_set(date_w, date);
+        widget_set(time_w, tm);
+        widget_set(dht_w, dht);
+        lat[i] = bench_ns() - t0;
+
+        // 첫 프레임(전체 그리기)은 전송량 평균에서 제외
+        if (i > 0) {
+            for (r = 0; r < ndirty; r++)
+                dirty_bytes += dirty[r].width * dirty[r].pages;
+        }
+        ndirty = 0;
+    }
+    return (double)dirty_bytes / (BENCH_FRAMES - 1);
+}
+
+int main(void) {
+    char date[20], tm[20], dht[32];
+    uint64_t t0;
+    double widget_bytes, app_bytes;
+    int i;
+
+    // legacy와 같은 화면: 5x7 폰트로 페이지 0/2/4, 컬럼 10
+    widget_t date_w = { .font = &font_small, .x = 10, .y = 0 };
+    widget_t time_w = { .font = &font_small, .x = 10, .y = 16 };
+    widget_t dht_w  = { .font = &font_small, .x = 10, .y = 32 };
+
+    // app.c main()의 실제 화면
+    widget_t app_date_w = { .font = &font_small, .x = 10, .y = 0 };
+    widget_t app_time_w = { .font = &font_big,   .x = 16, .y = 24 };
+    widget_t app_dht_w  = { .font = &font_small, .x = 10, .y = 48 };
+
+    for (i = 0; i < BENCH_FRAMES; i++) {
+        frame_strings(i, date, tm, dht);
+
+        t0 = bench_ns();
+        memset(legacy_buffer, 0, 1024);
+        legacy_draw_string(0, 10, date);
+        legacy_draw_string(2, 10, tm);
+        legacy_draw_string(4, 10, dht);
+        lat_legacy[i] = bench_ns() - t0;
+    }
+
+    widget_bytes = bench_widgets(&date_w, &time_w, &dht_w, lat_widget);
+    app_bytes = bench_widgets(&app_date_w, &app_time_w, &app_dht_w, lat_app);
+
+    printf("{\n");
+    print_pct("legacy_render_us", lat_legacy, BENCH_FRAMES, 0);
+    print_pct("widget_render_us", lat_widget, BENCH_FRAMES, 0);
+    print_pct("widget_app_layout_render_us", lat_app, BENCH_FRAMES, 0);
+    printf("  \"legacy_bytes_per_frame\": 1024,\n");
+    printf("  \"widget_dirty_bytes_per_frame\": %.1f,\n", widget_bytes);
+    printf("  \"widget_app_layout_dirty_bytes_per_frame\": %.1f\n", app_bytes);
+    printf("}\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+// dht11_decode.h
+// DHT11 에지 타임스탬프 → 40비트 복원 (dht11_driver.c와 hw_sim.c가 같이 사용)
+// 에지 기록/통계/tracepoint는 하지 않고 기록된 에지 배열만 해석한다
+
+#ifndef _DHT11_DECODE_H
+#define _DHT11_DECODE_H
+
+#ifdef __KERNEL__
+#include <linux/types.h>
+#include <linux/errno.h>
+#include <linux/math64.h>
+#else
+#include <stdint.h>
+#include <errno.h>
+typedef uint8_t  u8;
+typedef uint32_t u32;
+typedef int64_t  s64;
+typedef uint64_t u64;
+#define div64_s64(a, b) ((a) / (b))
+#endif
+
+// 응답(LOW/HIGH/LOW) 3개 + 비트당 2개(상승/하강) x 40 = 83개, 끝의 라인 해제까지 여유
+#define DHT_MAX_EDGES       96
+// HIGH 길이로 비트 판정: 0 = 26~28us, 1 = 70us → 중간값 49us (응답 펄스가 명목 80us일 때)
+// 실제 기준은 측정마다 응답 펄스/비트 앞 LOW 실측 길이에 비례해서 보정 (dht_decode_edges)
+#define DHT_BIT1_MIN_NS     49000
+#define DHT_PREAMBLE_NS     80000   // 센서 응답 LOW/HIGH
+#define DHT_BIT_LOW_NS      50000   // 비트마다 앞의 LOW
+
+// 에지마다 시각(ns)과 바뀐 레벨
+struct dht_edge {
+    u64 ns;
+    int level;
+};
+
+// 디코딩 결과: 원본 5바이트 + 판정 기준/여유 (tracepoint, 실패 원인 분류용)
+struct dht_decode {
+    u8 data[5];
+    int nhigh;          // 모은 HIGH 구간 수 (41개 미만이면 -EIO)
+    u32 thr_ns;         // 이번에 쓴 0/1 판정 기준
+    u32 zero_max_ns;    // 0으로 판정한 HIGH 중 최장 (없으면 0)
+    u32 one_min_ns;     // 1로 판정한 HIGH 중 최단 (없으면 0)
+};
+
+static inline int dht_checksum_ok(const u8 data[5])
+{
+    return (u8)(data[0] + data[1] + data[2] + data[3]) == data[4];
+}
+
+static inline void dht_note_bit(struct dht_decode *r, int bit, u32 high_ns)
+{
+    if (bit) {
+        if (!r->one_min_ns || high_ns < r->one_min_ns)
+            r->one_min_ns = high_ns;
+    } else if (high_ns > r->zero_max_ns) {
+        r->zero_max_ns = high_ns;
+    }
+}
+
+/*
+ * ====== 기록된 에지로 40비트 복원 ======
+ * HIGH 구간(상승→하강) 길이만 모으면 마지막 40개가 데이터 비트,
+ * 그 바로 앞이 센서 응답의 80us HIGH, 그 앞 LOW가 응답 80us LOW.
+ *
+ * 0/1 판정 기준은 고정값 대신 측정마다 보정 (센서 RC 클럭 오차/온도 드리프트 대응):
+ * 응답 LOW/HIGH(명목 80us)와 비트마다 앞의 LOW(명목 50us)를 모두 더해 명목 합과의 비율로
+ * 센서 클럭 배율을 구하고, DHT_BIT1_MIN_NS를 같은 비율로 조정.
+ * (응답 펄스 2개만 쓰면 지터가 그대로 기준에 실리므로 42개 구간으로 평균)
+ *
+ * 리턴: 0, -EIO (HIGH가 41개 안 됨), -EBADMSG (체크섬 불일치, r->data는 그대로 채움)
+ * 체크섬이 틀려도 고치지 않음 (8비트 합이라 어느 비트가 틀렸는지 알 수 없음 → 재시도에 맡김)
+ */
+static inline int dht_decode_edges(const struct dht_edge *e, int nedges, struct dht_decode *r)
+{
+    s64 high[DHT_MAX_EDGES / 2];
+    int high_at[DHT_MAX_EDGES / 2];     // 각 HIGH 구간이 시작된 에지 번호
+    int nhigh = 0;
+    int i, j, bit;
+    s64 *d, ref, nominal, thr;
+
+    for (i = 0; i < 5; i++)
+        r->data[i] = 0;
+    r->thr_ns = 0;
+    r->zero_max_ns = 0;
+    r->one_min_ns = 0;
+
+    for (i = 0; i + 1 < nedges && nhigh < DHT_MAX_EDGES / 2; i++) {
+        if (e[i].level == 1 && e[i + 1].level == 0) {
+            high_at[nhigh] = i;
+            high[nhigh++] = e[i + 1].ns - e[i].ns;
+        }
+    }
+    r->nhigh = nhigh;
+
+    // 응답 HIGH 1개 + 데이터 40비트가 안 모였으면 실패
+    if (nhigh < 41)
+        return -EIO;
+
+    d = &high[nhigh - 40];
+
+    // 센서 클럭 배율 보정: 응답 HIGH + (응답 LOW, 비트 앞 LOW들)의 실측 합 / 명목 합
+    ref = high[nhigh - 41];
+    nominal = DHT_PREAMBLE_NS;
+    for (i = nhigh - 41; i < nhigh; i++) {
+        j = high_at[i];
+        if (j > 0 && e[j - 1].level == 0) {
+            ref += e[j].ns - e[j - 1].ns;
+            nominal += (i == nhigh - 41) ? DHT_PREAMBLE_NS : DHT_BIT_LOW_NS;
+        }
+    }
+    thr = div64_s64(ref * DHT_BIT1_MIN_NS, nominal);
+    // 응답을 일부 놓친 경우 등 말이 안 되는 값이면 명목 기준 사용
+    if (thr < DHT_BIT1_MIN_NS / 2 || thr > DHT_BIT1_MIN_NS * 2)
+        thr = DHT_BIT1_MIN_NS;
+    r->thr_ns = (u32)thr;
+
+    for (i = 0; i < 40; i++) {
+        bit = (d[i] > thr) ? 1 : 0;
+        dht_note_bit(r, bit, (u32)d[i]);
+
+        // i번째 비트를 data[]에 채우기 (MSB first)
+        r->data[i / 8] = (r->data[i / 8] << 1) | bit;
+    }
+
+    return dht_checksum_ok(r->data) ? 0 : -EBADMSG;
+}
+
+#endif /* _DHT11_DECODE_H */
@@ -11,6 +11,20 @@
 #include <linux/jiffies.h>
 #include <linux/errno.h>
 #include <linux/interrupt.h>
+#include <linux/ktime.h>
+#include <linux/completion.h>
+#include <linux/mutex.h>
+#include <linux/moduleparam.h>
+#include <linux/workqueue.h>
+#include <linux/seqlock.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#define CREATE_TRACE_POINTS
+#include "dht11_trace.h"    // dht11:* tracepoint (측정 시작/끝, 비트 판정 여유)
 
 #define DEV_NAME "dht11_driver"
 
@@ -18,22 +32,117 @@
 #define DHT_GPIO 4   // 필요하면 바꿔라 (예: BCM17이면 17)
 
 // DHT11은 너무 자주 읽으면 안 됨(권장 1초 이상 간격)
+// → 백그라운드 샘플링 주기의 하한
 #define MIN_READ_INTERVAL_MS 1000
 
 // 타임아웃(마이크로초 단위) - 무한루프 방지
 #define TIMEOUT_US 200
 
+// ====== 인터럽트(에지 타임스탬프) 디코더 설정 ======
+// 에지 → 비트 판정 규칙과 DHT_MAX_EDGES/판정 기준값은 dht11_decode.h (hw_sim.c와 공용)
+#include "dht11_decode.h"
+#define DHT_EXPECTED_EDGES  83
+// 한 트랜잭션은 약 4~5ms → 넉넉하게 10ms 기다림
+// jiffies 타임아웃은 다음 tick에서 바로 끝날 수 있으므로 1 jiffy를 더함 (HZ=100이면 1 jiffy = 10ms)
+#define DHT_CAPTURE_TIMEOUT_MS 10
+#define DHT_CAPTURE_TIMEOUT_JIFFIES (msecs_to_jiffies(DHT_CAPTURE_TIMEOUT_MS) + 1)
+
+// 백그라운드 샘플링 주기 (ms)
+static unsigned int sample_period_ms = 2000;
+module_param(sample_period_ms, uint, 0644);
+MODULE_PARM_DESC(sample_period_ms, "Background sampling period in ms (min 1000)");
+
+static bool irq_mode = true;
+module_param(irq_mode, bool, 0444);
+MODULE_PARM_DESC(irq_mode, "Decode from both-edge IRQ timestamps instead of busy-wait polling");
+
+// 측정 실패 시 다음 주기까지 기다리지 않고 재시도
+// (재시도 간격도 MIN_READ_INTERVAL_MS 이상, 재시도는 샘플링 주기 안에서만,
+//  다음 정기 측정 시점은 그대로 유지)
+static unsigned int retry_delay_ms = MIN_READ_INTERVAL_MS;
+module_param(retry_delay_ms, uint, 0644);
+MODULE_PARM_DESC(retry_delay_ms, "Delay before retrying a failed read in ms (min 1000)");
+
+static unsigned int max_retries = 3;
+module_param(max_retries, uint, 0644);
+MODULE_PARM_DESC(max_retries, "Retries per sampling period after a failed read");
+
 typedef struct {
     int hum;   // 습도
     int temp;  // 온도
 } dht11_info_t;
 
+// 확장 포맷: read 버퍼가 이 크기 이상이면 측정 시각/순번까지 전달
+typedef struct {
+    int hum;                 // 습도
+    int temp;                // 온도
+    unsigned int seq;        // 성공한 측정마다 1씩 증가 (1부터)
+    unsigned int age_ms;     // 측정 후 지난 시간
+    long long timestamp_ns;  // 측정 시각 (CLOCK_MONOTONIC)
+} dht11_sample_t;
+
 static dev_t dht_dev;
 static struct cdev dht_cdev;
 static struct class *dht_class;
 static struct device *dht_device;
 
-static unsigned long last_read_jiffies; // 마지막 성공/시도 시간(간격 제한)
+/*
+ * 마지막으로 성공한 측정값 (백그라운드 워커가 갱신)
+ * seqlock이라 읽는 쪽은 워커를 막지 않고, 워커도 읽는 쪽을 기다리지 않음
+ */
+static dht11_sample_t dht_sample;
+static DEFINE_SEQLOCK(dht_sample_lock);
+static DECLARE_WAIT_QUEUE_HEAD(dht_wq);   // 새 측정값 대기 (blocking read / poll)
+
+static struct delayed_work dht_sample_work;
+
+// 센서 트랜잭션 직렬화 (동시에 두 프로세스가 읽으면 파형이 깨짐)
+static DEFINE_MUTEX(dht_lock);
+
+// 인터럽트 모드: 에지마다 시각(ns)과 바뀐 레벨을 기록
+static struct dht_edge dht_edges[DHT_MAX_EDGES];
+static int dht_nedges;
+static bool dht_capturing;          // true일 때만 ISR이 에지를 기록
+static int dht_irq = -1;
+static DECLARE_COMPLETION(dht_done);
+
+/*
+ * debugfs 통계 (/sys/kernel/debug/dht11_driver/stats)
+ * CPU별 카운터: 증가는 this_cpu_inc 한 번, 읽을 때만 합산
+ * -EIO 타임아웃은 어느 단계에서 끊겼는지로 나눠서 셈
+ */
+enum {
+    DHT_STAT_ATTEMPTS,          // 센서 측정 시도
+    DHT_STAT_SUCCESS,           // 체크섬까지 통과
+    DHT_STAT_TIMEOUT_ACK_LOW,   // 시작 신호 후 센서가 LOW로 응답하지 않음 (미연결/무응답)
+    DHT_STAT_TIMEOUT_ACK_HIGH,  // 응답 80us HIGH가 안 오거나 안 끝남
+    DHT_STAT_TIMEOUT_BIT_LOW,   // 데이터 비트 앞 50us LOW에서 끊김
+    DHT_STAT_TIMEOUT_BIT_HIGH,  // 데이터 비트 HIGH가 안 끝남
+    DHT_STAT_CHECKSUM,          // -EBADMSG (40비트는 받았지만 체크섬 불일치)
+    DHT_STAT_EAGAIN,            // O_NONBLOCK read인데 아직 측정값이 없음
+    DHT_STAT_RETRIES,           // 실패 후 주기를 기다리지 않고 바로 다시 시도한 횟수
+    DHT_STAT_NR
+};
+
+static const char * const dht_stat_names[DHT_STAT_NR] = {
+    "attempts", "success", "timeout_ack_low", "timeout_ack_high",
+    "timeout_bit_low", "timeout_bit_high", "checksum_errors", "eagain",
+    "retries",
+};
+
+struct dht_stats {
+    u64 cnt[DHT_STAT_NR];
+};
+
+static DEFINE_PER_CPU(struct dht_stats, dht_stats);
+static struct dentry *dht_debugfs_dir;
+
+#define dht_stat_inc(i) this_cpu_inc(dht_stats.cnt[i])
+
+// 마지막 측정의 비트 판정 여유 (tracepoint용, dht_lock 안에서만 갱신)
+// zero_max: 0으로 판정한 HIGH 중 최장, one_min: 1로 판정한 HIGH 중 최단 (ns, 없으면 0)
+static u32 dht_zero_max_ns, dht_one_min_ns;
+static u32 dht_thr_ns;              // 마지막 측정에 쓴 0/1 판정 기준
 
 // ====== 유틸: 특정 레벨이 될 때까지 기다리기 ======
 static int wait_for_level(int gpio, int level, int timeout_us)
@@ -47,14 +156,75 @@ static int wait_for_level(int gpio, int level, int timeout_us)
     return 0;
 }
 
-// ====== 핵심: DHT11 한 번 읽기 ======
+// ====== 인터럽트 핸들러: 에지 시각만 기록하고 바로 리턴 ======
+static irqreturn_t dht_irq_handler(int irq, void *dev_id)
+{
+    if (!READ_ONCE(dht_capturing) || dht_nedges >= DHT_MAX_EDGES)
+        return IRQ_HANDLED;
+
+    dht_edges[dht_nedges].ns = ktime_get_ns();
+    dht_edges[dht_nedges].level = gpio_get_value(DHT_GPIO);
+    dht_nedges++;
+
+    if (dht_nedges == DHT_EXPECTED_EDGES)
+        complete(&dht_done);
+
+    return IRQ_HANDLED;
+}
+
+/*
+ * ====== 기록된 에지로 40비트 복원 (규칙은 dht11_decode.h) ======
+ * 결과를 tracepoint용 판정 여유에 남기고, -EIO면 어느 단계에서 끊겼는지
+ * 모인 HIGH 개수와 마지막 에지 레벨로 나눠서 셈
+ */
+static int dht11_decode_edges(u8 out[5])
+{
+    struct dht_decode r;
+    int ret;
+
+    ret = dht_decode_edges(dht_edges, dht_nedges, &r);
+
+    if (ret == -EIO) {
+        if (dht_nedges == 0)
+            dht_stat_inc(DHT_STAT_TIMEOUT_ACK_LOW);
+        else if (r.nhigh == 0)
+            dht_stat_inc(DHT_STAT_TIMEOUT_ACK_HIGH);
+        else if (dht_edges[dht_nedges - 1].level == 1)
+            dht_stat_inc(DHT_STAT_TIMEOUT_BIT_HIGH);
+        else
+            dht_stat_inc(DHT_STAT_TIMEOUT_BIT_LOW);
+    }
+
+    dht_thr_ns = r.thr_ns;
+    dht_zero_max_ns = r.zero_max_ns;
+    dht_one_min_ns = r.one_min_ns;
+    memcpy(out, r.data, 5);
+    return ret;
+}
+
+// 폴링 모드: 라인이 level이 될 때까지 기다렸다가 그 시각을 에지로 기록
+static int dht_poll_edge(int level)
+{
+    if (wait_for_level(DHT_GPIO, level, TIMEOUT_US) < 0)
+        return -ETIMEDOUT;
+
+    dht_edges[dht_nedges].ns = ktime_get_ns();
+    dht_edges[dht_nedges].level = level;
+    dht_nedges++;
+    return 0;
+}
+
+// ====== 폴링 방식: DHT11 한 번 읽기 (irq_mode=0) ======
 // out[0]=hum_int, out[1]=hum_dec, out[2]=temp_int, out[3]=temp_dec, out[4]=checksum
-static int dht11_read_raw(u8 out[5])
+// 루프 횟수로 길이를 재면 udelay(1) + gpio_get_value() 비용만큼 CPU 클럭/부하에 따라
+// 기준이 흔들리므로, 에지마다 ktime 시각을 찍어 인터럽트 방식과 같은 디코더로 해석
+static int dht11_read_raw_polled(u8 out[5])
 {
-    int i, bit;
+    int i;
+    int phase;                  // 지금 기다리는 단계 (타임아웃 통계용)
     unsigned long flags;
 
-    u8 data[5] = {0,0,0,0,0};
+    dht_nedges = 0;
 
     // 타이밍 민감 구간: 인터럽트로 깨지면 실패율 폭증
     local_irq_save(flags);
@@ -66,88 +236,232 @@ static int dht11_read_raw(u8 out[5])
     udelay(30);                 // 20~40us 정도 HIGH
     gpio_direction_input(DHT_GPIO); // 입력 전환
 
-    // 2) 센서 응답: LOW(약80us) -> HIGH(약80us)
-    if (wait_for_level(DHT_GPIO, 0, TIMEOUT_US) < 0) { local_irq_restore(flags); return -EIO; }
-    if (wait_for_level(DHT_GPIO, 1, TIMEOUT_US) < 0) { local_irq_restore(flags); return -EIO; }
-    if (wait_for_level(DHT_GPIO, 0, TIMEOUT_US) < 0) { local_irq_restore(flags); return -EIO; }
+    // 2) 센서 응답: LOW(약80us) -> HIGH(약80us) -> 첫 비트 LOW
+    phase = DHT_STAT_TIMEOUT_ACK_LOW;
+    if (dht_poll_edge(0) < 0) goto timeout;
+    phase = DHT_STAT_TIMEOUT_ACK_HIGH;
+    if (dht_poll_edge(1) < 0) goto timeout;
+    if (dht_poll_edge(0) < 0) goto timeout;
 
-    // 3) 데이터 40비트 읽기
-    // 각 비트: LOW(약50us) -> HIGH(26~28us=0 / 70us=1)
+    // 3) 데이터 40비트: LOW(약50us) -> HIGH(26~28us=0 / 70us=1), 에지 시각만 기록
     for (i = 0; i < 40; i++) {
-        int high_len = 0;
+        phase = DHT_STAT_TIMEOUT_BIT_LOW;
+        if (dht_poll_edge(1) < 0) goto timeout;
+        phase = DHT_STAT_TIMEOUT_BIT_HIGH;
+        if (dht_poll_edge(0) < 0) goto timeout;
+    }
 
-        // LOW 시작(이미 LOW일 수 있지만 안정적으로 기다림)
-        if (wait_for_level(DHT_GPIO, 0, TIMEOUT_US) < 0) { local_irq_restore(flags); return -EIO; }
+    local_irq_restore(flags);
 
-        // HIGH 시작
-        if (wait_for_level(DHT_GPIO, 1, TIMEOUT_US) < 0) { local_irq_restore(flags); return -EIO; }
+    // 4) 판정 + 체크섬 검사
+    return dht11_decode_edges(out);
 
-        // HIGH 지속 시간 측정 (us 단위)
-        while (gpio_get_value(DHT_GPIO) == 1) {
-            udelay(1);
-            if (++high_len >= TIMEOUT_US) { local_irq_restore(flags); return -EIO; }
-        }
+timeout:
+    local_irq_restore(flags);
+    dht_stat_inc(phase);
+    return -EIO;
+}
 
-        // 판정: 대략 40us 기준으로 0/1 구분 (환경 따라 30~50us 조절 가능)
-        bit = (high_len > 40) ? 1 : 0;
+// ====== 인터럽트 방식: DHT11 한 번 읽기 ======
+// 시작 신호는 잠들어서(usleep) 보내고, 응답은 ISR이 기록한 에지 시각으로 나중에 해석.
+// 인터럽트를 끄는 구간이 없음
+static int dht11_read_raw_irq(u8 out[5])
+{
+    dht_nedges = 0;
+    reinit_completion(&dht_done);
 
-        // i번째 비트를 data[]에 채우기 (MSB first)
-        data[i/8] <<= 1;
-        data[i/8] |= bit;
-    }
+    // 1) MCU(Start signal): DATA를 출력으로 LOW 18ms 이상 유지
+    gpio_direction_output(DHT_GPIO, 0);
+    usleep_range(18000, 20000);
+    gpio_set_value(DHT_GPIO, 1);
+    udelay(30);                     // 20~40us 정도 HIGH
 
-    local_irq_restore(flags);
+    // 2) 입력 전환과 동시에 에지 기록 시작
+    WRITE_ONCE(dht_capturing, true);
+    gpio_direction_input(DHT_GPIO);
 
-    // 바이트 5개 복사
-    for (i = 0; i < 5; i++)
-        out[i] = data[i];
+    // 3) 83개 에지가 모이거나 타임아웃까지 대기
+    wait_for_completion_timeout(&dht_done, DHT_CAPTURE_TIMEOUT_JIFFIES);
+    WRITE_ONCE(dht_capturing, false);
+    synchronize_irq(dht_irq);       // 실행 중인 ISR이 끝날 때까지
 
-    // 4) 체크섬 검사
-    if ((u8)(data[0] + data[1] + data[2] + data[3]) != data[4])
-        return -EBADMSG;
+    return dht11_decode_edges(out);
+}
 
-    return 0;
+// ====== 핵심: DHT11 한 번 읽기 ======
+static int dht11_read_raw(u8 out[5])
+{
+    int ret;
+    bool use_irq;
+
+    mutex_lock(&dht_lock);
+    use_irq = irq_mode && dht_irq >= 0;
+
+    // 중간에 실패하면 out[]이 안 채워지므로 trace에 쓰레기 값이 안 찍히게 비워 둠
+    memset(out, 0, 5);
+    dht_zero_max_ns = 0;
+    dht_one_min_ns = 0;
+    dht_thr_ns = 0;
+    trace_dht11_read_start(use_irq);
+    dht_stat_inc(DHT_STAT_ATTEMPTS);
+
+    if (use_irq)
+        ret = dht11_read_raw_irq(out);
+    else
+        ret = dht11_read_raw_polled(out);
+
+    trace_dht11_read_end(use_irq, ret, out, dht_nedges, dht_thr_ns,
+                         dht_zero_max_ns, dht_one_min_ns);
+    if (ret == 0)
+        dht_stat_inc(DHT_STAT_SUCCESS);
+    else if (ret == -EBADMSG)
+        dht_stat_inc(DHT_STAT_CHECKSUM);
+    mutex_unlock(&dht_lock);
+
+    return ret;
 }
 
-// ====== file ops: read ======
-static ssize_t dht_read(struct file *file, char __user *buf, size_t count, loff_t *ppos)
+// ====== 백그라운드 샘플링 워커 ======
+// 주기마다 센서를 읽고, 성공하면 값을 게시한 뒤 기다리는 reader를 깨움
+static unsigned int dht_retries;        // 이번 주기에 한 재시도 횟수
+static unsigned int dht_retry_spent_ms; // 이번 주기에 재시도 대기로 쓴 시간
+// 주기 시작(첫 시도) 때 파라미터를 떠 둔 값 (0644라 주기 중간에 바뀌어도 계산이 어긋나지 않게)
+static unsigned int dht_period_ms, dht_retry_ms;
+
+static void dht_sample_work_func(struct work_struct *work)
 {
     u8 raw[5];
     int ret;
-    dht11_info_t info;
 
-    // read를 여러 번 호출해도 한번만 주고 끝내고 싶으면(표준적인 char read):
-    // 오프셋이 0이 아니면 EOF 처리
-    if (*ppos != 0)
-        return 0;
+    if (dht_retries == 0) {
+        dht_period_ms = max_t(unsigned int, READ_ONCE(sample_period_ms), MIN_READ_INTERVAL_MS);
+        dht_retry_ms = max_t(unsigned int, READ_ONCE(retry_delay_ms), MIN_READ_INTERVAL_MS);
+        dht_retry_spent_ms = 0;
+    }
 
-    // 1초 간격 제한 (너무 자주 읽으면 센서가 값 안 줌/에러남)
-    if (time_before(jiffies, last_read_jiffies + msecs_to_jiffies(MIN_READ_INTERVAL_MS)))
-        return -EAGAIN;
+    ret = dht11_read_raw(raw);
+    if (ret == 0) {
+        write_seqlock(&dht_sample_lock);
+        // DHT11: [0]=습도정수, [1]=습도소수(보통 0), [2]=온도정수, [3]=온도소수(보통 0)
+        dht_sample.hum  = (int)raw[0];
+        dht_sample.temp = (int)raw[2];
+        dht_sample.timestamp_ns = ktime_get_ns();
+        dht_sample.seq++;
+        write_sequnlock(&dht_sample_lock);
+
+        wake_up_interruptible(&dht_wq);
+    } else {
+        pr_debug("DHT11: sample failed (%d), retry %u\n", ret, dht_retries);
+
+        // 주기 안에 재시도할 여유가 있으면 다음 정기 측정 전에 한 번 더
+        if (dht_retries < READ_ONCE(max_retries) &&
+            dht_retry_spent_ms + dht_retry_ms < dht_period_ms) {
+            dht_retries++;
+            dht_retry_spent_ms += dht_retry_ms;
+            dht_stat_inc(DHT_STAT_RETRIES);
+            schedule_delayed_work(&dht_sample_work, msecs_to_jiffies(dht_retry_ms));
+            return;
+        }
+    }
 
-    last_read_jiffies = jiffies;
+    // 다음 정기 측정은 이번 주기 첫 시도 기준으로 (재시도로 밀리지 않게)
+    // 위 조건으로 dht_retry_spent_ms < dht_period_ms 이지만 음수가 되지 않도록 한 번 더 막음
+    schedule_delayed_work(&dht_sample_work,
+                          msecs_to_jiffies(dht_period_ms > dht_retry_spent_ms ?
+                                           dht_period_ms - dht_retry_spent_ms : dht_period_ms));
+    dht_retries = 0;
+}
 
-    ret = dht11_read_raw(raw);
-    if (ret < 0)
-        return ret;
+// 게시된 측정값 복사 (seq == 0이면 아직 측정값 없음)
+static void dht_get_sample(dht11_sample_t *out)
+{
+    unsigned int seq;
+
+    do {
+        seq = read_seqbegin(&dht_sample_lock);
+        *out = dht_sample;
+    } while (read_seqretry(&dht_sample_lock, seq));
+
+    out->age_ms = (unsigned int)div_u64(ktime_get_ns() - out->timestamp_ns, NSEC_PER_MSEC);
+}
+
+// ====== debugfs: stats ======
+// 모든 CPU 카운터 합산
+static int dht_stats_show(struct seq_file *m, void *v)
+{
+    u64 sum[DHT_STAT_NR] = {0};
+    int cpu, i;
+
+    for_each_possible_cpu(cpu) {
+        for (i = 0; i < DHT_STAT_NR; i++)
+            sum[i] += per_cpu_ptr(&dht_stats, cpu)->cnt[i];
+    }
+
+    for (i = 0; i < DHT_STAT_NR; i++)
+        seq_printf(m, "%-18s %llu\n", dht_stat_names[i], (unsigned long long)sum[i]);
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(dht_stats);
 
-    // DHT11: [0]=습도정수, [1]=습도소수(보통 0), [2]=온도정수, [3]=온도소수(보통 0)
-    info.hum  = (int)raw[0];
-    info.temp = (int)raw[2];
+// ====== file ops: read ======
+// 센서를 직접 건드리지 않고 캐시된 최신값을 돌려줌 (간격 제한 없음)
+// 아직 한 번도 측정에 성공하지 못했으면 O_NONBLOCK은 -EAGAIN, 아니면 첫 값까지 대기
+static ssize_t dht_read(struct file *file, char __user *buf, size_t count, loff_t *ppos)
+{
+    dht11_sample_t sample;
+    dht11_info_t info;
+    int ret;
 
     // 유저가 구조체 크기보다 적게 읽겠다고 하면 최소한만 보내는건 애매해서 에러 처리
     if (count < sizeof(dht11_info_t))
         return -EINVAL;
 
+    dht_get_sample(&sample);
+    if (sample.seq == 0) {
+        if (file->f_flags & O_NONBLOCK) {
+            dht_stat_inc(DHT_STAT_EAGAIN);
+            return -EAGAIN;
+        }
+
+        ret = wait_event_interruptible(dht_wq, READ_ONCE(dht_sample.seq) != 0);
+        if (ret)
+            return ret;
+        dht_get_sample(&sample);
+    }
+
+    // 이 파일이 마지막으로 본 순번 (poll 판정용)
+    file->private_data = (void *)(unsigned long)sample.seq;
+
+    // 확장 포맷을 받을 수 있으면 통째로
+    if (count >= sizeof(dht11_sample_t)) {
+        if (copy_to_user(buf, &sample, sizeof(dht11_sample_t)))
+            return -EFAULT;
+        return sizeof(dht11_sample_t);
+    }
+
+    info.hum  = sample.hum;
+    info.temp = sample.temp;
+
     if (copy_to_user(buf, &info, sizeof(dht11_info_t)))
         return -EFAULT;
 
-    *ppos += sizeof(dht11_info_t);
     return sizeof(dht11_info_t);
 }
 
+// ====== file ops: poll ======
+// 이 파일이 아직 읽지 않은 새 측정값이 있으면 읽기 가능
+static __poll_t dht_poll(struct file *file, poll_table *wait)
+{
+    poll_wait(file, &dht_wq, wait);
+
+    if (READ_ONCE(dht_sample.seq) != (unsigned int)(unsigned long)file->private_data)
+        return EPOLLIN | EPOLLRDNORM;
+    return 0;
+}
+
 static int dht_open(struct inode *inode, struct file *file)
 {
+    file->private_data = (void *)0UL;  // 아직 본 측정값 없음
     return 0;
 }
 
@@ -161,6 +475,7 @@ static const struct file_operations dht_fops = {
     .open    = dht_open,
     .release = dht_release,
     .read    = dht_read,
+    .poll    = dht_poll,
 };
 
 // ====== init/exit ======
@@ -178,10 +493,25 @@ static int __init dht_init(void)
     }
     gpio_direction_input(DHT_GPIO); // 기본은 입력
 
+    // 인터럽트 모드: 양쪽 에지 IRQ 등록 (실패하면 폴링 방식으로 동작)
+    if (irq_mode) {
+        dht_irq = gpio_to_irq(DHT_GPIO);
+        if (dht_irq >= 0)
+            ret = request_irq(dht_irq, dht_irq_handler,
+                              IRQF_TRIGGER_RISING | IRQF_TRIGGER_FALLING,
+                              "dht11_data", NULL);
+        if (dht_irq < 0 || ret) {
+            pr_warn("DHT11: edge IRQ unavailable, falling back to polling\n");
+            dht_irq = -1;
+        }
+    }
+
     // 2) chrdev 번호 할당
     ret = alloc_chrdev_region(&dht_dev, 0, 1, DEV_NAME);
     if (ret < 0) {
         pr_err("DHT11: alloc_chrdev_region failed\n");
+        if (dht_irq >= 0)
+            free_irq(dht_irq, NULL);
         gpio_free(DHT_GPIO);
         return ret;
     }
@@ -194,6 +524,8 @@ static int __init dht_init(void)
     if (ret < 0) {
         pr_err("DHT11: cdev_add failed\n");
         unregister_chrdev_region(dht_dev, 1);
+        if (dht_irq >= 0)
+            free_irq(dht_irq, NULL);
         gpio_free(DHT_GPIO);
         return ret;
     }
@@ -204,6 +536,8 @@ static int __init dht_init(void)
         pr_err("DHT11: class_create failed\n");
         cdev_del(&dht_cdev);
         unregister_chrdev_region(dht_dev, 1);
+        if (dht_irq >= 0)
+            free_irq(dht_irq, NULL);
         gpio_free(DHT_GPIO);
         return PTR_ERR(dht_class);
     }
@@ -214,24 +548,38 @@ static int __init dht_init(void)
         class_destroy(dht_class);
         cdev_del(&dht_cdev);
         unregister_chrdev_region(dht_dev, 1);
+        if (dht_irq >= 0)
+            free_irq(dht_irq, NULL);
         gpio_free(DHT_GPIO);
         return PTR_ERR(dht_device);
     }
 
-    last_read_jiffies = 0;
+    // debugfs 통계 (실패해도 드라이버 동작에는 영향 없음)
+    dht_debugfs_dir = debugfs_create_dir(DEV_NAME, NULL);
+    debugfs_create_file("stats", 0444, dht_debugfs_dir, NULL, &dht_stats_fops);
+
+    // 백그라운드 샘플링 시작 (첫 측정은 바로)
+    INIT_DELAYED_WORK(&dht_sample_work, dht_sample_work_func);
+    schedule_delayed_work(&dht_sample_work, 0);
     pr_info("DHT11: /dev/%s created (major=%d minor=%d)\n",
             DEV_NAME, MAJOR(dht_dev), MINOR(dht_dev));
-    pr_info("DHT11: read returns struct {int hum; int temp}\n");
+    pr_info("DHT11: read returns cached struct {int hum; int temp} (or dht11_sample_t), period %u ms\n",
+            max_t(unsigned int, sample_period_ms, MIN_READ_INTERVAL_MS));
 
     return 0;
 }
 
 static void __exit dht_exit(void)
 {
+    cancel_delayed_work_sync(&dht_sample_work);
+    debugfs_remove_recursive(dht_debugfs_dir);
+
     device_destroy(dht_class, dht_dev);
     class_destroy(dht_class);
     cdev_del(&dht_cdev);
     unregister_chrdev_region(dht_dev, 1);
+    if (dht_irq >= 0)
+        free_irq(dht_irq, NULL);
     gpio_free(DHT_GPIO);
 
     pr_info("DHT11: exit\n");
@@ -0,0 +1,70 @@
+// dht11_trace.h
+// dht11 드라이버 tracepoint (/sys/kernel/tracing/events/dht11/)
+// 측정 한 번의 시작/끝과 비트 판정 여유(margin)를 기록
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM dht11
+
+#if !defined(_DHT11_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _DHT11_TRACE_H
+
+#include <linux/tracepoint.h>
+
+// 측정 시작: 1 = 인터럽트(에지 타임스탬프) 방식, 0 = 폴링 방식
+TRACE_EVENT(dht11_read_start,
+    TP_PROTO(int irq),
+    TP_ARGS(irq),
+    TP_STRUCT__entry(
+        __field(int, irq)
+    ),
+    TP_fast_assign(
+        __entry->irq = irq;
+    ),
+    TP_printk("irq=%d", __entry->irq)
+);
+
+/*
+ * 측정 끝: 리턴값, 원본 5바이트, 체크섬 일치 여부, 모은 에지 수,
+ * 응답 펄스로 보정한 0/1 판정 기준, 0으로 판정한 HIGH 중 가장 긴 것 /
+ * 1로 판정한 HIGH 중 가장 짧은 것 (ns). 두 값이 기준에 가까우면 오판 직전이라는 뜻
+ */
+TRACE_EVENT(dht11_read_end,
+    TP_PROTO(int irq, int ret, const u8 *data, int edges, u32 thr_ns,
+             u32 zero_max_ns, u32 one_min_ns),
+    TP_ARGS(irq, ret, data, edges, thr_ns, zero_max_ns, one_min_ns),
+    TP_STRUCT__entry(
+        __field(int, irq)
+        __field(int, ret)
+        __array(u8, data, 5)
+        __field(int, csum_ok)
+        __field(int, edges)
+        __field(u32, thr_ns)
+        __field(u32, zero_max_ns)
+        __field(u32, one_min_ns)
+    ),
+    TP_fast_assign(
+        __entry->irq = irq;
+        __entry->ret = ret;
+        memcpy(__entry->data, data, 5);
+        __entry->csum_ok = (u8)(data[0] + data[1] + data[2] + data[3]) == data[4];
+        __entry->edges = edges;
+        __entry->thr_ns = thr_ns;
+        __entry->zero_max_ns = zero_max_ns;
+        __entry->one_min_ns = one_min_ns;
+    ),
+    TP_printk("irq=%d ret=%d data=%02x %02x %02x %02x %02x csum_ok=%d edges=%d thr=%uns zero_max=%uns one_min=%uns",
+              __entry->irq, __entry->ret,
+              __entry->data[0], __entry->data[1], __entry->data[2],
+              __entry->data[3], __entry->data[4],
+              __entry->csum_ok, __entry->edges, __entry->thr_ns,
+              __entry->zero_max_ns, __entry->one_min_ns)
+);
+
+#endif /* _DHT11_TRACE_H */
+
+// 이 헤더는 드라이버 소스와 같은 디렉터리에 있음 (Makefile: CFLAGS_dht11_driver.o := -I$(src))
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE dht11_trace
+#include <trace/define_trace.h>
@@ -0,0 +1,174 @@
+// ds1302_bitbang.h
+// DS1302 3선 비트뱅잉 + BCD 레지스터 변환 (rtc_control_driver.c와 hw_sim.c가 같이 사용)
+//
+// 포함하기 전에 GPIO_RTC_RST / GPIO_RTC_CLK / GPIO_RTC_DAT 와
+// gpio_set_value(), gpio_get_value(), gpio_direction_output(), gpio_direction_input(), udelay()가
+// 있어야 함 (커널: <linux/gpio.h>, <linux/delay.h> / 시뮬레이터: 핀 모델 함수)
+// 여기 함수들은 버스 잠금/tracepoint/통계를 하지 않음 → 드라이버 쪽 래퍼에서 처리
+
+#ifndef _DS1302_BITBANG_H
+#define _DS1302_BITBANG_H
+
+// BCD → 10진수 변환 매크로
+#define BCD2BIN(val) (((val) & 0x0f) + ((val) >> 4) * 10)
+
+// 10진수 → BCD 변환 매크로
+#define BIN2BCD(val) ((((val) / 10) << 4) + ((val) % 10))
+
+// DS1302 명령 바이트
+#define DS1302_CMD_WP_WRITE    0x8E   // Write Protect 레지스터 쓰기
+#define DS1302_CMD_BURST_WRITE 0xBE   // clock burst 쓰기 (8바이트)
+#define DS1302_CMD_BURST_READ  0xBF   // clock burst 읽기 (8바이트)
+
+// CE 타이밍 (데이터시트 VCC = 2.0V 기준, 3.3V에서도 여유)
+// CE HIGH → 첫 SCLK 상승 tCC 4us, 트랜잭션 사이 CE LOW 유지 tCWH 4us
+#define DS1302_T_CC_US   4
+#define DS1302_T_CWH_US  4
+
+// DS1302 시간 레지스터 전체 (burst 순서와 동일, 10진수)
+typedef struct {
+    int seconds;  // 0~59
+    int minutes;  // 0~59
+    int hours;    // 0~23 (24시간 모드)
+    int date;     // 1~31
+    int month;    // 1~12
+    int day;      // 1~7 (요일)
+    int year;     // 0~99 (2000~2099)
+} ds1302_time_t;
+
+// DS1302로 1바이트 쓰기 (LSB first)
+static inline void ds1302_write_byte(unsigned char dat)
+{
+    int i;
+
+    // DAT 핀을 출력으로 설정
+    gpio_direction_output(GPIO_RTC_DAT, 0);
+
+    // 8비트 전송
+    for (i = 0; i < 8; i++) {
+        // 현재 LSB를 DAT 핀으로 출력
+        gpio_set_value(GPIO_RTC_DAT, dat & 0x01);
+        udelay(2);
+
+        // CLK 상승 에지
+        gpio_set_value(GPIO_RTC_CLK, 1);
+        udelay(2);
+
+        // CLK 하강 에지
+        gpio_set_value(GPIO_RTC_CLK, 0);
+        udelay(2);
+
+        // 다음 비트
+        dat >>= 1;
+    }
+}
+
+// DS1302에서 1바이트 읽기 (LSB first)
+static inline unsigned char ds1302_read_byte(void)
+{
+    int i;
+    unsigned char dat = 0;
+
+    // DAT 핀을 입력으로 설정
+    gpio_direction_input(GPIO_RTC_DAT);
+
+    for (i = 0; i < 8; i++) {
+        dat >>= 1;
+
+        // DAT 핀 값 읽기
+        if (gpio_get_value(GPIO_RTC_DAT))
+            dat |= 0x80;
+
+        gpio_set_value(GPIO_RTC_CLK, 1);
+        udelay(2);
+        gpio_set_value(GPIO_RTC_CLK, 0);
+        udelay(2);
+    }
+    return dat;
+}
+
+// 레지스터 하나 쓰기 (CE HIGH → 명령 → 데이터 → CE LOW)
+static inline void __ds1302_write_reg(unsigned char cmd, unsigned char data)
+{
+    gpio_set_value(GPIO_RTC_RST, 1);  // 통신 시작
+    udelay(DS1302_T_CC_US);
+    ds1302_write_byte(cmd);           // 주소 전송
+    ds1302_write_byte(data);          // 데이터 전송
+    gpio_set_value(GPIO_RTC_RST, 0);  // 통신 종료
+    gpio_set_value(GPIO_RTC_CLK, 0);  // CLK 안정화
+    udelay(DS1302_T_CWH_US);          // 다음 트랜잭션까지 CE LOW 유지
+}
+
+// 레지스터 하나 읽기
+static inline unsigned char __ds1302_read_reg(unsigned char cmd)
+{
+    unsigned char data;
+
+    gpio_set_value(GPIO_RTC_RST, 1);  // 통신 시작
+    udelay(DS1302_T_CC_US);
+    ds1302_write_byte(cmd);           // 읽기 명령
+    data = ds1302_read_byte();        // 데이터 수신
+    gpio_set_value(GPIO_RTC_RST, 0);  // 통신 종료
+    gpio_set_value(GPIO_RTC_CLK, 0);
+    udelay(DS1302_T_CWH_US);
+    return data;
+}
+
+// clock burst 읽기: CE 한 번에 시간 레지스터 8개를 연속으로 읽음
+// (0x81~0x8F를 따로 읽으면 중간에 초가 넘어갈 수 있지만 burst는 한 시점의 스냅샷)
+static inline void __ds1302_burst_read(unsigned char regs[8])
+{
+    int i;
+
+    gpio_set_value(GPIO_RTC_RST, 1);
+    udelay(DS1302_T_CC_US);
+    ds1302_write_byte(DS1302_CMD_BURST_READ);
+    for (i = 0; i < 8; i++)
+        regs[i] = ds1302_read_byte();
+    gpio_set_value(GPIO_RTC_RST, 0);
+    gpio_set_value(GPIO_RTC_CLK, 0);
+    udelay(DS1302_T_CWH_US);
+}
+
+// clock burst 쓰기: 8바이트(초~연도 + 컨트롤)를 한 번에 씀
+// burst 쓰기는 8개를 모두 보내야 반영됨. 마지막 바이트가 Write Protect 레지스터
+static inline void __ds1302_burst_write(const unsigned char regs[8])
+{
+    int i;
+
+    gpio_set_value(GPIO_RTC_RST, 1);
+    udelay(DS1302_T_CC_US);
+    ds1302_write_byte(DS1302_CMD_BURST_WRITE);
+    for (i = 0; i < 8; i++)
+        ds1302_write_byte(regs[i]);
+    gpio_set_value(GPIO_RTC_RST, 0);
+    gpio_set_value(GPIO_RTC_CLK, 0);
+    udelay(DS1302_T_CWH_US);
+}
+
+// burst로 읽은 레지스터 8개 → 날짜/시간
+static inline void ds1302_regs_to_time(const unsigned char r[8], ds1302_time_t *t)
+{
+    t->seconds = BCD2BIN(r[0] & 0x7F);  // bit7 = Clock Halt
+    t->minutes = BCD2BIN(r[1] & 0x7F);
+    t->hours   = BCD2BIN(r[2] & 0x3F);  // 24시간 모드 (bit7 = 12/24)
+    t->date    = BCD2BIN(r[3] & 0x3F);
+    t->month   = BCD2BIN(r[4] & 0x1F);
+    t->day     = BCD2BIN(r[5] & 0x07);
+    t->year    = BCD2BIN(r[6]);
+}
+
+// 날짜/시간 → burst 쓰기용 레지스터 8개 (마지막은 Write Protect ON)
+static inline void ds1302_time_to_regs(const ds1302_time_t *t, unsigned char r[8])
+{
+    r[0] = BIN2BCD(t->seconds);  // CH = 0 → 발진 동작
+    r[1] = BIN2BCD(t->minutes);
+    r[2] = BIN2BCD(t->hours);    // 24시간 모드
+    r[3] = BIN2BCD(t->date);
+    r[4] = BIN2BCD(t->month);
+    r[5] = BIN2BCD(t->day);
+    r[6] = BIN2BCD(t->year);
+    r[7] = 0x80;                 // Write Protect ON (burst 마지막 바이트)
+}
+
+#endif /* _DS1302_BITBANG_H */
@@ -0,0 +1,1450 @@
+// hw_sim.c
+// 라즈베리파이 없이 app.c를 돌려 보기 위한 유저 공간 하드웨어 시뮬레이터
+//
+// - DS1302: 핀 레벨 모델 (CE/SCLK/IO 에지 단위, 단일 레지스터 + clock burst, Write Protect)
+// - DHT11 : 40비트 응답 파형(에지 시각) 생성기, 지터/센서 클럭 오차 설정 가능
+// - SSD1306: I2C 컨트롤 바이트 + 명령/데이터 스트림을 해석해서 128x64 GDDRAM 복원
+//
+// 드라이버 쪽 로직(비트뱅잉, OLED 초기화/창/diff 인코딩, DHT 에지 디코딩)은
+// 드라이버와 같은 헤더(ds1302_bitbang.h, oled_ssd1306.h, dht11_decode.h)를 그대로 포함해서
+// 모델에 물리고, app.c에는 디바이스 파일 대신 pty(/dev/smart_clock 대용), FIFO(/dev/dht11_driver 대용),
+// mmap 가능한 1024바이트 파일(/dev/my_oled 대용, ioctl은 hw_sim_preload.so가 넘겨 줌)을 넘긴다.
+//
+// 빌드/실행: make sim  (또는 ./hw_sim -t 10 -j 5 ./app, -W: app의 write() 경로)
+//           make bench (-J: 결과를 백분위 JSON으로 출력)
+//           ./hw_sim -D 10000 -j 15 -s 70  (앱 없이 DHT 디코더만: 고정 기준 vs 보정 기준)
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <termios.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/timerfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+// === app.c / 드라이버와 주고받는 구조체 (각 드라이버와 동일하게 유지) ===
+typedef struct {
+    int hours;
+    int minutes;
+    int seconds;
+    int mode;
+} clock_info_t;
+
+typedef struct {
+    int hum;
+    int temp;
+} dht11_info_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* =========================================================
+ * DS1302 모델 (핀 레벨)
+ * 명령/쓰기 데이터는 SCLK 상승 에지에서 IO를 샘플링 (LSB first),
+ * 읽기 데이터는 SCLK 하강 에지마다 다음 비트를 IO에 내보냄
+ * ========================================================= */
+
+#define GPIO_RTC_RST 16
+#define GPIO_RTC_CLK 20
+#define GPIO_RTC_DAT 21
+
+typedef struct {
+    int ce, clk, host_io;     // 호스트가 구동하는 핀 레벨
+    int io_out;               // 칩이 구동하는 IO 레벨 (읽기 중)
+    unsigned char reg[8];     // 초, 분, 시, 일, 월, 요일, 연, WP (BCD)
+    unsigned char shift;      // 수신 중인 바이트
+    int nbits;
+    int have_cmd;
+    unsigned char cmd;
+    int idx;                  // burst 진행 위치
+    unsigned char out_byte;
+    int out_bits;
+    unsigned long transactions;
+    // 타이밍 검사용: 마지막 에지 시각 (가상 시간, ns)
+    uint64_t t_ce_up, t_ce_down, t_clk_up, t_clk_down, t_io;
+    int clk_up_seen;          // 이번 트랜잭션에서 SCLK가 올라간 적 있음
+} ds1302_t;
+
+static ds1302_t ds;
+
+// 실제로 기다리지 않고 드라이버가 바쁘게 기다렸을 시간만 누적 (트랜잭션 비용 측정용)
+// GPIO 조작 자체는 0으로 보므로 핀 에지 사이 간격 = 그 사이 udelay 합 (실제보다 짧게 = 보수적)
+static uint64_t ds_busy_us;
+static uint64_t ds_now_ns(void) { return ds_busy_us * 1000; }
+
+/*
+ * DS1302 AC 타이밍 최소값 (데이터시트, VCC = 2.0V 열 = 가장 느린 조건)
+ * 모델이 에지마다 간격을 재서 항목별 최소값을 ds_tmin[]에 남김 (-T에서 규격과 비교)
+ */
+enum { DS_T_CC, DS_T_CWH, DS_T_CL, DS_T_CH, DS_T_DC, DS_T_CDH, DS_T_CCH, DS_T_CDD, DS_T_NR };
+
+static const struct { const char *name; uint64_t min_ns; } ds_spec[DS_T_NR] = {
+    [DS_T_CC]  = { "tCC  CE to CLK setup",   4000 },
+    [DS_T_CWH] = { "tCWH CE inactive",       4000 },
+    [DS_T_CL]  = { "tCL  CLK low",           1000 },
+    [DS_T_CH]  = { "tCH  CLK high",          1000 },
+    [DS_T_DC]  = { "tDC  data to CLK setup",  200 },
+    [DS_T_CDH] = { "tCDH CLK to data hold",   280 },
+    [DS_T_CCH] = { "tCCH CLK to CE hold",     240 },
+    [DS_T_CDD] = { "tCDD CLK to data valid",  800 },   // 칩 출력 지연: 호스트는 이보다 늦게 읽어야 함
+};
+
+static uint64_t ds_tmin[DS_T_NR];
+
+static void ds_timing_reset(void) {
+    int i;
+
+    for (i = 0; i < DS_T_NR; i++)
+        ds_tmin[i] = UINT64_MAX;
+}
+
+static void ds_timing(int which, uint64_t since) {
+    uint64_t dt = ds_now_ns() - since;
+
+    if (dt < ds_tmin[which]) ds_tmin[which] = dt;
+}
+
+static int ds_is_read(void)  { return ds.cmd & 0x01; }
+static int ds_is_burst(void) { return ((ds.cmd >> 1) & 0x1F) == 31; }
+
+static unsigned char ds_reg_read(void) {
+    int addr = ds_is_burst() ? ds.idx++ : (ds.cmd >> 1) & 0x1F;
+    return (addr < 8) ? ds.reg[addr] : 0;
+}
+
+static void ds_reg_write(unsigned char v) {
+    int addr = ds_is_burst() ? ds.idx++ : (ds.cmd >> 1) & 0x1F;
+
+    if (addr >= 8) return;
+    // WP(bit7)가 켜져 있으면 WP 레지스터 말고는 무시
+    if (addr != 7 && (ds.reg[7] & 0x80)) return;
+    ds.reg[addr] = v;
+}
+
+static void ds_set_ce(int v) {
+    if (v && !ds.ce) {
+        if (ds.transactions) ds_timing(DS_T_CWH, ds.t_ce_down);
+        ds.t_ce_up = ds_now_ns();
+        ds.clk_up_seen = 0;
+        ds.nbits = 0;
+        ds.shift = 0;
+        ds.have_cmd = 0;
+        ds.idx = 0;
+        ds.out_bits = 0;
+        ds.transactions++;
+    } else if (!v && ds.ce) {
+        ds_timing(DS_T_CCH, ds.t_clk_down);
+        ds.t_ce_down = ds_now_ns();
+    }
+    ds.ce = v;
+}
+
+static void ds_set_clk(int v) {
+    int rising = v && !ds.clk;
+    int falling = !v && ds.clk;
+
+    ds.clk = v;
+    if (!ds.ce) return;
+
+    if (rising) {
+        ds_timing(DS_T_CC, ds.t_ce_up);
+        ds_timing(DS_T_CL, ds.t_clk_down);
+        if (!ds.have_cmd || !ds_is_read()) ds_timing(DS_T_DC, ds.t_io);
+        ds.t_clk_up = ds_now_ns();
+        ds.clk_up_seen = 1;
+    } else if (falling) {
+        ds_timing(DS_T_CH, ds.t_clk_up);
+        ds.t_clk_down = ds_now_ns();
+    }
+
+    if (rising && (!ds.have_cmd || !ds_is_read())) {
+        ds.shift |= (ds.host_io & 1) << ds.nbits;
+        if (++ds.nbits == 8) {
+            if (!ds.have_cmd) {
+                // 명령 바이트: bit7 = 1, bit6 = RAM(1)/CK(0)는 시계만 모델링
+                ds.cmd = ds.shift;
+                ds.have_cmd = (ds.cmd & 0x80) && !(ds.cmd & 0x40);
+            } else {
+                ds_reg_write(ds.shift);
+            }
+            ds.nbits = 0;
+            ds.shift = 0;
+        }
+    } else if (falling && ds.have_cmd && ds_is_read()) {
+        if (ds.out_bits == 0) {
+            ds.out_byte = ds_reg_read();
+            ds.out_bits = 8;
+        }
+        ds.io_out = ds.out_byte & 1;
+        ds.out_byte >>= 1;
+        ds.out_bits--;
+    }
+}
+
+// 드라이버 코드가 그대로 호출하는 GPIO 함수 → 모델 핀
+static void gpio_set_value(int pin, int v) {
+    if (pin == GPIO_RTC_RST) ds_set_ce(v);
+    else if (pin == GPIO_RTC_CLK) ds_set_clk(v);
+    else if (pin == GPIO_RTC_DAT) {
+        // 이번 트랜잭션에서 SCLK가 올라간 뒤의 데이터 변경만 hold 검사
+        if (ds.ce && ds.clk_up_seen)
+            ds_timing(DS_T_CDH, ds.t_clk_up);
+        ds.host_io = v;
+        ds.t_io = ds_now_ns();
+    }
+}
+
+static int gpio_get_value(int pin) {
+    if (pin != GPIO_RTC_DAT) return 0;
+    if (ds.ce) ds_timing(DS_T_CDD, ds.t_clk_down);
+    return ds.io_out;
+}
+
+static void gpio_direction_output(int pin, int v) { gpio_set_value(pin, v); }
+static void gpio_direction_input(int pin) { (void)pin; }
+
+static void udelay(int us) { ds_busy_us += us; }
+
+// rtc_control_driver.c와 같은 비트뱅잉/BCD 변환 (공용 헤더, 위 GPIO 함수로 모델 핀을 구동)
+#include "ds1302_bitbang.h"
+
+// 발진기 1초 진행 (CH 비트가 켜져 있으면 멈춤)
+static void ds_tick(void) {
+    static const int mdays[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int s, m, h, d, mo, y;
+
+    if (ds.reg[0] & 0x80) return;
+
+    s = BCD2BIN(ds.reg[0] & 0x7F) + 1;
+    m = BCD2BIN(ds.reg[1] & 0x7F);
+    h = BCD2BIN(ds.reg[2] & 0x3F);
+    d = BCD2BIN(ds.reg[3] & 0x3F);
+    mo = BCD2BIN(ds.reg[4] & 0x1F);
+    y = BCD2BIN(ds.reg[6]);
+
+    if (s == 60) { s = 0; m++; }
+    if (m == 60) { m = 0; h++; }
+    if (h == 24) {
+        h = 0;
+        d++;
+        ds.reg[5] = ds.reg[5] % 7 + 1;
+    }
+    if (mo < 1 || mo > 12) mo = 1;
+    if (d > mdays[mo - 1]) { d = 1; mo++; }
+    if (mo == 13) { mo = 1; y = (y + 1) % 100; }
+
+    ds.reg[0] = BIN2BCD(s);
+    ds.reg[1] = BIN2BCD(m);
+    ds.reg[2] = BIN2BCD(h);
+    ds.reg[3] = BIN2BCD(d);
+    ds.reg[4] = BIN2BCD(mo);
+    ds.reg[6] = BIN2BCD(y);
+}
+
+// 마지막으로 읽은 날짜/시간 (드라이버의 rtc_now처럼 쓸 때 날짜 유지용)
+static ds1302_time_t rtc_now;
+
+// 드라이버의 get_rtc_time() 대응: burst 한 번으로 시/분/초
+static void rtc_read_clock(clock_info_t *c) {
+    unsigned char r[8];
+
+    __ds1302_burst_read(r);
+    ds1302_regs_to_time(r, &rtc_now);
+    c->seconds = rtc_now.seconds;
+    c->minutes = rtc_now.minutes;
+    c->hours   = rtc_now.hours;
+    c->mode    = 0;
+}
+
+// 드라이버의 set_rtc_time() → ds1302_write_time() 대응: 날짜는 유지하고 WP OFF + burst 쓰기
+static void rtc_write_clock(const clock_info_t *c) {
+    unsigned char r[8];
+
+    rtc_now.seconds = c->seconds;
+    rtc_now.minutes = c->minutes;
+    rtc_now.hours   = c->hours;
+    ds1302_time_to_regs(&rtc_now, r);
+
+    __ds1302_write_reg(DS1302_CMD_WP_WRITE, 0x00);
+    __ds1302_burst_write(r);
+}
+
+// 화면 크기, oled_rect_t/ioctl 번호, 초기화 테이블, 창/diff/구간 인코딩 (oled_driver.c와 공용)
+#include "oled_ssd1306.h"
+#include "hw_sim.h"            // hw_sim_preload.so와 주고받는 sim_oled_req_t
+
+/* =========================================================
+ * SSD1306 모델
+ * I2C 메시지 하나 = [컨트롤 바이트][...]
+ *   Co=0: 나머지 전부 명령(D/C=0) 또는 데이터(D/C=1)
+ *   Co=1: 다음 1바이트만 해당, 그 뒤에 다시 컨트롤 바이트
+ * ========================================================= */
+
+typedef struct {
+    unsigned char ram[8][128];
+    int mode;                          // 0: 가로, 1: 세로, 2: 페이지 주소 모드
+    int col_start, col_end, page_start, page_end;
+    int col, page;
+    int display_on, contrast;
+    unsigned char cmd[8];              // 인자 모으는 중인 명령
+    int ncmd, need;
+    unsigned long bytes;               // 주소 바이트 포함 버스 바이트 수
+    unsigned long msgs;
+} ssd1306_t;
+
+static ssd1306_t oled = { .col_end = 127, .page_end = 7, .mode = 2 };
+
+// 명령별 인자 바이트 수
+static int ssd_cmd_args(unsigned char c) {
+    switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    }
+    return 0;
+}
+
+static void ssd_exec(const unsigned char *c) {
+    switch (c[0]) {
+    case 0x20: oled.mode = c[1] & 3; return;
+    case 0x21: oled.col_start = c[1] & 0x7F; oled.col_end = c[2] & 0x7F; oled.col = oled.col_start; return;
+    case 0x22: oled.page_start = c[1] & 7; oled.page_end = c[2] & 7; oled.page = oled.page_start; return;
+    case 0x81: oled.contrast = c[1]; return;
+    case 0xAE: oled.display_on = 0; return;
+    case 0xAF: oled.display_on = 1; return;
+    }
+    // 페이지 주소 모드용 단일 바이트 명령
+    if (c[0] >= 0xB0 && c[0] <= 0xB7) oled.page = c[0] & 7;
+    else if (c[0] <= 0x0F) oled.col = (oled.col & 0xF0) | c[0];
+    else if (c[0] >= 0x10 && c[0] <= 0x1F) oled.col = (oled.col & 0x0F) | ((c[0] & 0x0F) << 4);
+}
+
+static void ssd_cmd_byte(unsigned char b) {
+    if (oled.ncmd == 0)
+        oled.need = ssd_cmd_args(b);
+    oled.cmd[oled.ncmd++] = b;
+    if (oled.ncmd > oled.need) {
+        ssd_exec(oled.cmd);
+        oled.ncmd = 0;
+    }
+}
+
+static void ssd_data_byte(unsigned char b) {
+    oled.ram[oled.page][oled.col] = b;
+
+    if (oled.mode == 0) {
+        if (++oled.col > oled.col_end) {
+            oled.col = oled.col_start;
+            if (++oled.page > oled.page_end) oled.page = oled.page_start;
+        }
+    } else if (oled.mode == 1) {
+        if (++oled.page > oled.page_end) {
+            oled.page = oled.page_start;
+            if (++oled.col > oled.col_end) oled.col = oled.col_start;
+        }
+    } else {
+        oled.col = (oled.col + 1) & 0x7F;
+    }
+}
+
+// I2C 쓰기 메시지 하나 (START + 주소 + 페이로드)
+static void ssd_i2c_msg(const unsigned char *buf, int len) {
+    int i = 0;
+
+    oled.bytes += len + 1;
+    oled.msgs++;
+
+    while (i < len) {
+        unsigned char ctrl = buf[i++];
+        int co = ctrl & 0x80, dc = ctrl & 0x40;
+        int end = co ? i + 1 : len;
+
+        for (; i < end && i < len; i++) {
+            if (dc) ssd_data_byte(buf[i]);
+            else ssd_cmd_byte(buf[i]);
+        }
+    }
+}
+
+/* ---- oled_driver.c의 oled_flush()와 같은 순서 (초기화 테이블/전체·구간 인코딩은 공용 헤더) ---- */
+
+static unsigned char oled_shadow_buf[1 + OLED_FB_SIZE] = { 0x40 }; // 0x40 + 프레임 (전체 전송용)
+static unsigned char * const oled_shadow = oled_shadow_buf + 1;
+static int oled_shadow_valid = 0;
+static int oled_initialized = 0;
+static unsigned char oled_win_buf[OLED_PAGES][7];              // 0x00 + 0x21 c0 c1 + 0x22 p0 p1
+static unsigned char oled_span_buf[OLED_PAGES][OLED_WIDTH + 1]; // 0x40 + 한 페이지 최대 128바이트
+
+// write(1024) 또는 OLED_IOC_FLUSH(_RECT) 한 번에 해당하는 드라이버 동작
+static void oled_flush_rect(const unsigned char *fb, int col, int page, int width, int pages) {
+    oled_spans_t sp;
+    int i, p;
+
+    if (!oled_initialized) {
+        unsigned char msg[1 + sizeof(oled_init_cmds)];
+        msg[0] = 0x00;
+        memcpy(msg + 1, oled_init_cmds, sizeof(oled_init_cmds));
+        ssd_i2c_msg(msg, sizeof(msg));
+        oled_initialized = 1;
+    }
+
+    // 패널 내용을 모르면 영역과 상관없이 전체: 섀도에 먼저 뜬 다음 섀도를 전송
+    if (!oled_shadow_valid) {
+        oled_encode_full(fb, oled_shadow, oled_win_buf[0]);
+        ssd_i2c_msg(oled_win_buf[0], 7);
+        ssd_i2c_msg(oled_shadow_buf, OLED_FB_SIZE + 1);
+        oled_shadow_valid = 1;
+        return;
+    }
+
+    // 드라이버와 같은 인코딩 → 메시지 쌍을 순서대로 버스에 → 섀도 반영
+    oled_encode_spans(fb, oled_shadow, col, page, width, pages, oled_win_buf, oled_span_buf, &sp);
+    for (i = 0; i < sp.n; i++) {
+        p = sp.page[i];
+        ssd_i2c_msg(oled_win_buf[p], 7);
+        ssd_i2c_msg(oled_span_buf[p], sp.len[i] + 1);
+    }
+    oled_commit_spans(oled_shadow, oled_span_buf, &sp);
+}
+
+/* =========================================================
+ * DHT11 파형 생성기
+ * 센서 응답 80us LOW / 80us HIGH, 이후 비트마다 50us LOW + 26~28us(0) 또는 70us(1) HIGH.
+ * 모든 구간을 센서 클럭 배율(scale %)로 늘이거나 줄이고, ±jitter us 균등 분포 지터를 더해서
+ * 에지(시각, 레벨) 목록으로 만든다
+ * ========================================================= */
+
+// struct dht_edge, 판정 기준값, dht_decode_edges()는 dht11_driver.c와 공용
+#include "dht11_decode.h"
+
+#define DHT_RETRIES     1       // 드라이버 기본값(주기 2000ms, 재시도 간격 1000ms)에서 주기 안에 들어가는 재시도 수
+
+static int dht_jitter_us = 0;
+static int dht_scale_pct = 100;   // 센서 RC 클럭 오차 (100 = 명목, 70 = 모든 구간 30% 짧음)
+
+static int64_t jitter_ns(void) {
+    if (dht_jitter_us <= 0) return 0;
+    return ((int64_t)(rand() % (2 * dht_jitter_us * 1000 + 1))) - dht_jitter_us * 1000;
+}
+
+static uint64_t seg_ns(int64_t nominal) {
+    return nominal * dht_scale_pct / 100 + jitter_ns();
+}
+
+static int dht_gen_waveform(const unsigned char data[5], struct dht_edge *e) {
+    uint64_t t = 20000;  // 시작 신호 후 센서 응답까지 (~20us)
+    int n = 0, i;
+
+    // 응답 LOW 80us → HIGH 80us
+    e[n].ns = t; e[n++].level = 0; t += seg_ns(80000);
+    e[n].ns = t; e[n++].level = 1; t += seg_ns(80000);
+
+    for (i = 0; i < 40; i++) {
+        int bit = (data[i / 8] >> (7 - i % 8)) & 1;
+
+        e[n].ns = t; e[n++].level = 0; t += seg_ns(50000);
+        e[n].ns = t; e[n++].level = 1; t += seg_ns(bit ? 70000 : 27000);
+    }
+
+    // 마지막 50us LOW 후 풀업으로 HIGH
+    e[n].ns = t; e[n++].level = 0; t += 50000;
+    e[n].ns = t; e[n++].level = 1;
+    return n;
+}
+
+// 폴링 모드(irq_mode=0) 드라이버가 인터럽트를 끄고 있는 시간 (us)
+// local_irq_save ~ 시작 신호 20ms + 30us + 센서 응답부터 마지막 비트 끝까지
+static int dht_irqoff_us(const struct dht_edge *e, int nedges) {
+    return 20000 + 30 + (int)((e[nedges - 2].ns - e[0].ns) / 1000);
+}
+
+// 예전 드라이버 규칙 (고정 49us 기준): 비교용으로만 사용
+static int dht_decode_fixed(const struct dht_edge *e, int nedges, unsigned char out[5]) {
+    int64_t high[DHT_MAX_EDGES / 2];
+    int nhigh = 0, i, bit;
+
+    memset(out, 0, 5);
+    for (i = 0; i + 1 < nedges; i++) {
+        if (e[i].level == 1 && e[i + 1].level == 0)
+            high[nhigh++] = e[i + 1].ns - e[i].ns;
+    }
+    if (nhigh < 41) return -EIO;
+
+    for (i = 0; i < 40; i++) {
+        bit = (high[nhigh - 40 + i] > DHT_BIT1_MIN_NS) ? 1 : 0;
+        out[i / 8] = (out[i / 8] << 1) | bit;
+    }
+    return dht_checksum_ok(out) ? 0 : -EBADMSG;
+}
+
+/* =========================================================
+ * 자체 검사 (-T)
+ * 드라이버와 공용인 헤더의 로직을 정해진 입력으로 돌려 기대값과 비교하고,
+ * 드라이버의 시계 상태 잠금 규칙을 여러 스레드로 두드려 봄 (앱 없이, 실패하면 종료 코드 1)
+ * ========================================================= */
+
+#include "rotary_decode.h"
+
+static int check_fail;
+
+static void check(int ok, const char *what) {
+    printf("  %-34s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) check_fail++;
+}
+
+/*
+ * 엔코더 에지 재생: 디텐트(3)에서 시작해 states[]를 edge_ms 간격으로 rot_decode_step()에 넣고
+ * 나온 이동량(0 제외)과 버린 디텐트 수를 비교
+ * 정방향 한 칸 = 3 → 2 → 0 → 1 → 3, 역방향 = 3 → 1 → 0 → 2 → 3
+ */
+typedef struct {
+    const char *name;
+    int states[12];     // -1로 끝
+    int edge_ms;
+    int steps[4];       // 기대 이동량, 0으로 끝
+    int rejected;
+} rot_case_t;
+
+static const rot_case_t rot_cases[] = {
+    { "rot: clean cw",                { 2, 0, 1, 3, -1 }, 100, { 1 }, 0 },
+    { "rot: clean ccw",               { 1, 0, 2, 3, -1 }, 100, { -1 }, 0 },
+    { "rot: bounce at detent",        { 2, 3, 2, 3, 2, 0, 1, 3, -1 }, 100, { 1 }, 2 },
+    { "rot: bounce mid detent",       { 2, 0, 2, 0, 1, 3, -1 }, 100, { 1 }, 0 },
+    { "rot: reversal mid detent",     { 2, 0, 2, 3, -1 }, 100, { 0 }, 1 },
+    { "rot: reversal after detent",   { 2, 0, 1, 3, 1, 0, 2, 3, -1 }, 100, { 1, -1 }, 0 },
+    { "rot: missed edge",             { 2, 1, 3, -1 }, 100, { 1 }, 0 },
+    { "rot: two missed edges",        { 0, 3, -1 }, 100, { 0 }, 1 },
+    { "rot: accel x10 (<30ms)",       { 2, 0, 1, 3, 2, 0, 1, 3, -1 }, 5, { 1, 10 }, 0 },
+    { "rot: accel x5 (<80ms)",        { 2, 0, 1, 3, 2, 0, 1, 3, -1 }, 12, { 1, 5 }, 0 },
+};
+
+static void check_rotary(void) {
+    unsigned i;
+
+    for (i = 0; i < sizeof(rot_cases) / sizeof(rot_cases[0]); i++) {
+        const rot_case_t *c = &rot_cases[i];
+        struct rot_decoder d = { .prev = ROT_REST_STATE, .last_detent_ms = -1000 };
+        int out[8], nout = 0, nrej = 0, k, rej, step, ok;
+
+        for (k = 0; c->states[k] >= 0; k++) {
+            step = rot_decode_step(&d, c->states[k], (long long)(k + 1) * c->edge_ms, &rej);
+            nrej += rej;
+            if (step && nout < 8) out[nout++] = step;
+        }
+
+        ok = (nrej == c->rejected);
+        for (k = 0; k < 4 && c->steps[k]; k++)
+            ok = ok && k < nout && out[k] == c->steps[k];
+        ok = ok && nout == k;
+        check(ok, c->name);
+    }
+}
+
+/*
+ * DS1302 버스 타이밍: 드라이버와 같은 비트뱅잉(ds1302_bitbang.h)을 핀 모델에 돌려서
+ * - 에지 간격이 데이터시트 최소값 이상인지 (ds_spec[])
+ * - burst 읽기/쓰기가 레지스터를 하나씩 다루는 것보다 버스 시간이 짧은지 (시간 레지스터 7개 기준)
+ * - burst 쓰기 → burst 읽기가 CE 한 번씩으로 같은 값을 돌려주는지
+ */
+static void check_ds1302(void) {
+    static const ds1302_time_t t = { 59, 59, 23, 31, 12, 5, 99 };
+    unsigned char w[8], r[8];
+    unsigned long tr;
+    uint64_t t0, single_rd, burst_rd, single_wr, burst_wr;
+    ds1302_time_t got;
+    char what[64];
+    int i;
+
+    memset(&ds, 0, sizeof(ds));
+    ds.reg[7] = 0x80;
+    ds_timing_reset();
+
+    // 쓰기: 레지스터별 (WP OFF + 7개 + WP ON) vs 드라이버 방식 (WP OFF + burst 8바이트)
+    ds1302_time_to_regs(&t, w);
+    t0 = ds_busy_us;
+    __ds1302_write_reg(DS1302_CMD_WP_WRITE, 0x00);
+    for (i = 0; i < 7; i++)
+        __ds1302_write_reg(0x80 + 2 * i, w[i]);
+    __ds1302_write_reg(DS1302_CMD_WP_WRITE, 0x80);
+    single_wr = ds_busy_us - t0;
+
+    memset(ds.reg, 0, 7);
+    t0 = ds_busy_us;
+    tr = ds.transactions;
+    __ds1302_write_reg(DS1302_CMD_WP_WRITE, 0x00);
+    __ds1302_burst_write(w);
+    burst_wr = ds_busy_us - t0;
+    check(ds.transactions - tr == 2 && !memcmp(ds.reg, w, 8), "ds1302: burst write in one CE");
+
+    // 읽기: 레지스터별 7번 vs burst 1번
+    t0 = ds_busy_us;
+    for (i = 0; i < 7; i++)
+        r[i] = __ds1302_read_reg(0x81 + 2 * i);
+    single_rd = ds_busy_us - t0;
+
+    memset(r, 0, sizeof(r));
+    t0 = ds_busy_us;
+    tr = ds.transactions;
+    __ds1302_burst_read(r);
+    burst_rd = ds_busy_us - t0;
+    ds1302_regs_to_time(r, &got);
+    check(ds.transactions - tr == 1 && !memcmp(&got, &t, sizeof(t)) && r[7] == 0x80,
+          "ds1302: burst read round trip");
+
+    // WP ON 상태의 쓰기는 무시되어야 함
+    __ds1302_write_reg(0x80, 0x00);
+    check(ds.reg[0] == w[0], "ds1302: write protect honored");
+
+    snprintf(what, sizeof(what), "ds1302: burst read %llu/%llu us",
+             (unsigned long long)burst_rd, (unsigned long long)single_rd);
+    check(burst_rd * 10 <= single_rd * 6, what);
+    snprintf(what, sizeof(what), "ds1302: burst write %llu/%llu us",
+             (unsigned long long)burst_wr, (unsigned long long)single_wr);
+    check(burst_wr * 10 <= single_wr * 6, what);
+
+    for (i = 0; i < DS_T_NR; i++) {
+        snprintf(what, sizeof(what), "ds1302: %s %llu >= %llu ns", ds_spec[i].name,
+                 (unsigned long long)ds_tmin[i], (unsigned long long)ds_spec[i].min_ns);
+        check(ds_tmin[i] != UINT64_MAX && ds_tmin[i] >= ds_spec[i].min_ns, what);
+    }
+}
+
+/*
+ * 시계 상태 동시 접근 스트레스
+ * 드라이버의 seqlock_t/rtc_bus_lock은 유저 공간에서 돌릴 수 없으므로 같은 규칙을 그대로 옮겨서 검사:
+ *   - 쓰는 쪽: writer 락 → seq 홀수 → 필드 → seq 짝수 (write_seqlock/write_sequnlock)
+ *   - 읽는 쪽: seq 읽기 → 필드 → seq 다시 읽기, 홀수거나 바뀌었으면 재시도 (read_seqbegin/retry)
+ *   - RTC 읽기/쓰기 + 상태 변경은 버스 락 안에서 (clock_write, rotary_apply, btn_work_func, get_rtc_time)
+ * writer 스레드: 타이머 tick, write(), 엔코더, 버튼, RTC 재동기화 / reader 스레드 여러 개
+ *
+ * 찢어진 읽기 판정: writer가 seq마다 공개한 상태를 hist[]에 남기고,
+ * reader는 스냅샷이 자기가 본 seq의 hist와 정확히 같은지 비교 (값 범위만 보면 섞여도 통과할 수 있음)
+ * 끝나면 DS1302 모델의 시/분/초가 마지막으로 버스에 쓴 값과 같은지도 확인 (버스 직렬화)
+ *
+ * 공개된 상태 검사: 정상 모드이고 보류 중인 편집이 없으면 공개된 시간은
+ * 마지막 RTC 쓰기 값 + 그 뒤 tick 수여야 함. 버스 락을 쥔 writer가 매번 확인하고
+ * 끝난 뒤에도 한 번 더 확인 (재동기화가 락 밖에서 오래된 값을 공개하면 여기서 걸림)
+ */
+#define CS_HIST      (1 << 16)
+#define CS_WRITES    20000      // writer 스레드당 반복
+#define CS_READERS   4
+
+static unsigned cs_seq;
+static clock_info_t cs_state;
+static clock_info_t cs_hist[CS_HIST];
+static pthread_mutex_t cs_wlock = PTHREAD_MUTEX_INITIALIZER;    // seqlock_t 안의 spinlock
+static pthread_mutex_t cs_bus = PTHREAD_MUTEX_INITIALIZER;      // rtc_bus_lock
+static int cs_stop;
+static unsigned long cs_reads, cs_retries, cs_torn, cs_skipped;
+static unsigned long cs_stale;    // 버스 락 안에서만 갱신
+
+// 필드 단위 relaxed 접근 (reader와 동시에 일어나는 쓰기를 C 메모리 모델 안에서 표현)
+static void cs_store(clock_info_t *d, const clock_info_t *v) {
+    __atomic_store_n(&d->hours, v->hours, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->minutes, v->minutes, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->seconds, v->seconds, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->mode, v->mode, __ATOMIC_RELAXED);
+}
+
+static void cs_load(clock_info_t *d, const clock_info_t *v) {
+    d->hours   = __atomic_load_n(&v->hours, __ATOMIC_RELAXED);
+    d->minutes = __atomic_load_n(&v->minutes, __ATOMIC_RELAXED);
+    d->seconds = __atomic_load_n(&v->seconds, __ATOMIC_RELAXED);
+    d->mode    = __atomic_load_n(&v->mode, __ATOMIC_RELAXED);
+}
+
+static void cs_write_begin(void) {
+    pthread_mutex_lock(&cs_wlock);
+    __atomic_store_n(&cs_seq, cs_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);                       // smp_wmb()
+}
+
+// 바뀐 상태를 공개 (writer 락 안이므로 cs_state는 그냥 읽어도 됨)
+static void cs_write_end(const clock_info_t *v) {
+    cs_store(&cs_state, v);
+    // 가끔 쓰기 구간 안에서 양보: CPU가 하나여도 reader가 홀수 seq를 만나게 함
+    if (cs_seq % 16 == 1) sched_yield();
+    cs_store(&cs_hist[((cs_seq + 1) / 2) % CS_HIST], v);
+    __atomic_store_n(&cs_seq, cs_seq + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&cs_wlock);
+    sched_yield();          // writer끼리만 돌지 않게 reader에게도 차례를 줌
+}
+
+// clock_get_state() 대응
+static __thread unsigned cs_nload;
+
+static unsigned cs_get_state(clock_info_t *out) {
+    unsigned seq;
+
+    for (;;) {
+        seq = __atomic_load_n(&cs_seq, __ATOMIC_ACQUIRE);
+        if (!(seq & 1)) {
+            out->hours   = __atomic_load_n(&cs_state.hours, __ATOMIC_RELAXED);
+            out->minutes = __atomic_load_n(&cs_state.minutes, __ATOMIC_RELAXED);
+            // 가끔 복사 도중 양보: 선점(타이머 IRQ 등)되는 경우를 CPU 하나에서도 재현
+            if (++cs_nload % 8 == 0) sched_yield();
+            out->seconds = __atomic_load_n(&cs_state.seconds, __ATOMIC_RELAXED);
+            out->mode    = __atomic_load_n(&cs_state.mode, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);               // smp_rmb()
+            if (__atomic_load_n(&cs_seq, __ATOMIC_RELAXED) == seq)
+                return seq;
+        }
+        __atomic_fetch_add(&cs_retries, 1, __ATOMIC_RELAXED);
+        sched_yield();      // cpu_relax() 대신: CPU가 하나면 writer가 끝나야 진행됨
+    }
+}
+
+static void cs_advance(clock_info_t *c, int secs) {
+    int total = (c->hours * 3600 + c->minutes * 60 + c->seconds + secs) % (24 * 3600);
+
+    c->hours   = total / 3600;
+    c->minutes = (total / 60) % 60;
+    c->seconds = total % 60;
+}
+
+// 버스 락 안에서만 접근
+static int cs_rtc_dirty;
+static clock_info_t cs_rtc_pending, cs_rtc_last;
+static int cs_ticks;    // 마지막 RTC 쓰기/재동기화 이후 tick 수, writer 락 안에서만 접근
+
+// 버스 락 + writer 락 안에서 호출: 공개된 상태가 DS1302 쪽 시간과 맞는지
+static int cs_state_synced(void) {
+    clock_info_t want = cs_rtc_last;
+
+    if (cs_state.mode != 0 || cs_rtc_dirty)
+        return 1;
+    cs_advance(&want, cs_ticks);
+    return cs_state.hours == want.hours && cs_state.minutes == want.minutes &&
+           cs_state.seconds == want.seconds;
+}
+
+static void cs_rtc_write(const clock_info_t *c) {
+    rtc_write_clock(c);
+    cs_rtc_last = *c;
+    cs_rtc_dirty = 0;
+}
+
+// hrtimer 콜백: 버스 락 없이 정상 모드면 1초 진행
+static void *cs_tick_thread(void *arg) {
+    clock_info_t c;
+    int i;
+
+    (void)arg;
+    for (i = 0; i < CS_WRITES; i++) {
+        cs_write_begin();
+        c = cs_state;
+        if (c.mode == 0) {
+            cs_advance(&c, 1);
+            cs_ticks++;
+        }
+        cs_write_end(&c);
+    }
+    return NULL;
+}
+
+// clock_write(): 버스 락 → 상태 변경 → RTC 쓰기
+static void *cs_write_thread(void *arg) {
+    unsigned r = (unsigned)(uintptr_t)arg;
+    clock_info_t c;
+    int i;
+
+    for (i = 0; i < CS_WRITES; i++) {
+        r = r * 1103515245u + 12345u;
+        pthread_mutex_lock(&cs_bus);
+        cs_write_begin();
+        if (!cs_state_synced()) cs_stale++;
+        c = cs_state;
+        c.hours = (r >> 8) % 24;
+        c.minutes = (r >> 16) % 60;
+        c.seconds = (r >> 24) % 60;
+        cs_ticks = 0;
+        cs_write_end(&c);
+        cs_rtc_write(&c);
+        pthread_mutex_unlock(&cs_bus);
+    }
+    return NULL;
+}
+
+// rotary_apply() + btn_work_func(): 설정 모드 편집은 보류했다가 정상 모드로 돌아갈 때 한 번에 쓰기
+static void *cs_input_thread(void *arg) {
+    clock_info_t c;
+    int i, delta;
+
+    (void)arg;
+    for (i = 0; i < CS_WRITES; i++) {
+        pthread_mutex_lock(&cs_bus);
+        cs_write_begin();
+        if (!cs_state_synced()) cs_stale++;
+        c = cs_state;
+        if (i % 16 == 0) {
+            c.mode = (c.mode + 1) % 3;
+        } else if (c.mode == 1) {
+            delta = (i & 1) ? 1 : -10;
+            c.hours = ((c.hours + delta) % 24 + 24) % 24;
+        } else if (c.mode == 2) {
+            delta = (i & 1) ? 5 : -1;
+            c.minutes = ((c.minutes + delta) % 60 + 60) % 60;
+            c.seconds = 0;
+        }
+        // 정상 모드로 돌아오며 보류분을 쓰면 공개 상태 == 쓸 값
+        if (c.mode == 0 && cs_rtc_dirty) cs_ticks = 0;
+        cs_write_end(&c);
+
+        if (c.mode != 0 && i % 16) {
+            cs_rtc_pending = c;
+            cs_rtc_dirty = 1;
+        } else if (c.mode == 0 && cs_rtc_dirty) {
+            cs_rtc_write(&cs_rtc_pending);
+        }
+        pthread_mutex_unlock(&cs_bus);
+    }
+    return NULL;
+}
+
+// resync_work_func() → get_rtc_time(): 버스 락을 쥔 채 읽고 정상 모드면 반영
+// (락을 먼저 풀면 그 사이 write()가 쓴 새 시간을 읽어 둔 옛 값으로 덮어씀)
+static void *cs_resync_thread(void *arg) {
+    clock_info_t t, c;
+    int i;
+
+    (void)arg;
+    for (i = 0; i < CS_WRITES; i++) {
+        pthread_mutex_lock(&cs_bus);
+        if (cs_rtc_dirty) {
+            pthread_mutex_unlock(&cs_bus);
+            continue;
+        }
+        rtc_read_clock(&t);
+        sched_yield();    // 느린 버스 읽기 흉내: 다른 writer가 끼어들 틈을 넓힘
+
+        cs_write_begin();
+        c = cs_state;
+        if (c.mode == 0) {
+            c.hours = t.hours;
+            c.minutes = t.minutes;
+            c.seconds = t.seconds;
+            cs_ticks = 0;
+        }
+        cs_write_end(&c);
+        pthread_mutex_unlock(&cs_bus);
+    }
+    return NULL;
+}
+
+static void *cs_read_thread(void *arg) {
+    clock_info_t c, h;
+    unsigned seq;
+    unsigned long n = 0, torn = 0, skipped = 0;
+
+    (void)arg;
+    while (!__atomic_load_n(&cs_stop, __ATOMIC_ACQUIRE)) {
+        seq = cs_get_state(&c);
+        cs_load(&h, &cs_hist[(seq / 2) % CS_HIST]);
+        // 그 사이 hist가 한 바퀴 돌아 덮였으면 비교 불가
+        if ((__atomic_load_n(&cs_seq, __ATOMIC_ACQUIRE) - seq) / 2 >= CS_HIST - 1) {
+            skipped++;
+            continue;
+        }
+        n++;
+        if (memcmp(&c, &h, sizeof(c)) || c.hours < 0 || c.hours > 23 || c.minutes < 0 ||
+            c.minutes > 59 || c.seconds < 0 || c.seconds > 59 || c.mode < 0 || c.mode > 2)
+            torn++;
+    }
+    __atomic_fetch_add(&cs_reads, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cs_torn, torn, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cs_skipped, skipped, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void check_clock_state(void) {
+    static void *(*const writers[])(void *) = {
+        cs_tick_thread, cs_write_thread, cs_write_thread, cs_input_thread, cs_resync_thread,
+    };
+    enum { NW = sizeof(writers) / sizeof(writers[0]) };
+    pthread_t w[NW], r[CS_READERS];
+    clock_info_t init = { 12, 0, 0, 0 }, rtc;
+    char what[80];
+    int i;
+
+    memset(&ds, 0, sizeof(ds));
+    ds.reg[7] = 0x80;
+    cs_store(&cs_state, &init);
+    cs_store(&cs_hist[0], &init);
+    rtc_write_clock(&init);
+    cs_rtc_last = init;
+    cs_ticks = 0;
+
+    for (i = 0; i < CS_READERS; i++)
+        pthread_create(&r[i], NULL, cs_read_thread, NULL);
+    for (i = 0; i < NW; i++)
+        pthread_create(&w[i], NULL, writers[i], (void *)(uintptr_t)(i + 1));
+    for (i = 0; i < NW; i++)
+        pthread_join(w[i], NULL);
+    __atomic_store_n(&cs_stop, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < CS_READERS; i++)
+        pthread_join(r[i], NULL);
+
+    snprintf(what, sizeof(what), "clock: %lu reads %lu retries, torn %lu",
+             cs_reads, cs_retries, cs_torn);
+    check(cs_reads > 0 && cs_torn == 0, what);
+
+    snprintf(what, sizeof(what), "clock: published state matches ds1302, stale %lu", cs_stale);
+    check(cs_stale == 0 && cs_state_synced(), what);
+
+    // 남은 편집 반영 후 DS1302에 마지막으로 쓴 값이 남아 있어야 함
+    if (cs_rtc_dirty) cs_rtc_write(&cs_rtc_pending);
+    rtc_read_clock(&rtc);
+    check(rtc.hours == cs_rtc_last.hours && rtc.minutes == cs_rtc_last.minutes &&
+          rtc.seconds == cs_rtc_last.seconds, "clock: ds1302 holds last bus write");
+}
+
+static int self_test(void) {
+    printf("hw_sim self test\n");
+    check_rotary();
+    check_ds1302();
+    check_clock_state();
+    printf("%s (%d failed)\n", check_fail ? "FAIL" : "PASS", check_fail);
+    return check_fail ? 1 : 0;
+}
+
+/* =========================================================
+ * 성능 측정 하네스
+ * ========================================================= */
+
+// 측정값 표본 (백분위 계산용)
+#define MAX_SAMPLES 65536
+
+typedef struct {
+    uint64_t v[MAX_SAMPLES];
+    int n;
+} samples_t;
+
+static void sample_add(samples_t *s, uint64_t v) {
+    if (s->n < MAX_SAMPLES) s->v[s->n++] = v;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 정렬 후 nearest-rank 백분위
+static uint64_t sample_pct(samples_t *s, int pct) {
+    int i;
+
+    if (s->n == 0) return 0;
+    qsort(s->v, s->n, sizeof(s->v[0]), cmp_u64);
+    i = (s->n * pct + 99) / 100 - 1;
+    return s->v[i < 0 ? 0 : i];
+}
+
+static uint64_t sample_sum(const samples_t *s) {
+    uint64_t sum = 0;
+    int i;
+    for (i = 0; i < s->n; i++) sum += s->v[i];
+    return sum;
+}
+
+typedef struct {
+    unsigned long ticks;            // 보낸 시계 상태 수
+    unsigned long encoder_events;   // 보낸 엔코더/버튼 이벤트 수
+    unsigned long frames;           // 받은 flush 수 (write() 1회 또는 FLUSH/FLUSH_RECT ioctl 1회)
+    samples_t tick_lat_ns;          // 초 증가 → 프레임 도착
+    samples_t enc_lat_ns;           // 스크립트 엔코더/버튼 상태 전송 → 프레임 도착
+    samples_t bus_bytes;            // 프레임당 버스 바이트
+    samples_t dht_irqoff_us;        // 폴링 모드 DHT 읽기 1회당 IRQ off 시간 (모델: 20ms + 30us + 파형 길이)
+    unsigned long mismatches;       // SSD1306 GDDRAM ≠ 앱 프레임
+    unsigned long rtc_errors;       // DS1302 모델 값 ≠ burst 읽기 결과
+    unsigned long dht_reads, dht_fail;  // 샘플 수 / 재시도까지 다 실패한 샘플
+    unsigned long dht_fail_fixed;       // 첫 파형을 예전 고정 기준으로 읽었을 때 실패
+    unsigned long dht_fail_first;       // 첫 파형을 보정 기준으로 읽었을 때 실패
+    unsigned long dht_retries;
+    uint64_t ds_read_us, ds_write_us; // DS1302 시간 읽기/쓰기 1회 비용 (모델: 드라이버 udelay 합)
+} sim_stats_t;
+
+static sim_stats_t st;
+
+// I2C Fast mode 400kHz: 바이트당 9클럭 (ACK 포함)
+#define I2C_NS_PER_BYTE (9 * 2500)
+
+/*
+ * 엔코더/버튼 시나리오 (rtc_control_driver.c와 같은 상태 변화)
+ * 버튼: 모드 0 → 1(시) → 2(분) → 0, 모드 0으로 돌아올 때 DS1302에 한 번 씀
+ * 회전: 설정 중인 필드 ±1, 설정 모드에서는 초가 멈춤
+ */
+static const int enc_script[] = { 0, +1, +1, 0, -1, 0 };  // 0 = 버튼, ±1 = 회전
+#define ENC_SCRIPT_LEN (int)(sizeof(enc_script) / sizeof(enc_script[0]))
+
+/*
+ * DHT11 샘플 1회: 드라이버 dht_sample_work_func()처럼 실패하면 새 파형으로 최대 DHT_RETRIES번 재시도
+ * 같은 첫 파형을 예전 고정 기준으로도 디코딩해서 비교용으로 셈
+ */
+static int dht_sim_sample(const unsigned char data[5], unsigned char out[5]) {
+    struct dht_edge e[DHT_MAX_EDGES];
+    struct dht_decode res;
+    int n, try, ret = -1;
+
+    st.dht_reads++;
+    for (try = 0; try <= DHT_RETRIES; try++) {
+        n = dht_gen_waveform(data, e);
+        if (try == 0) {
+            sample_add(&st.dht_irqoff_us, dht_irqoff_us(e, n));
+            if (dht_decode_fixed(e, n, out) != 0 || memcmp(out, data, 5))
+                st.dht_fail_fixed++;
+        } else {
+            st.dht_retries++;
+        }
+
+        ret = dht_decode_edges(e, n, &res);
+        memcpy(out, res.data, 5);
+        // 체크섬은 맞았는데 값이 틀린 경우도 실패로 셈 (시뮬레이터는 정답을 앎)
+        if (ret == 0 && memcmp(out, data, 5))
+            ret = -EILSEQ;
+        if (ret == 0)
+            break;
+        if (try == 0)
+            st.dht_fail_first++;
+    }
+    if (ret)
+        st.dht_fail++;
+    return ret;
+}
+
+// -D: 앱 없이 DHT 디코더만 n번 (임의 측정값) 돌리고 실패율 비교
+static int dht_only_run(int reads, int json) {
+    unsigned char data[5], out[5];
+    int i;
+
+    for (i = 0; i < reads; i++) {
+        data[0] = rand() % 96; data[1] = 0;
+        data[2] = rand() % 51; data[3] = 0;
+        data[4] = data[0] + data[1] + data[2] + data[3];
+        dht_sim_sample(data, out);
+    }
+
+    if (json) {
+        printf("{\n");
+        printf("  \"dht_jitter_us\": %d, \"dht_scale_pct\": %d, \"dht_reads\": %lu,\n",
+               dht_jitter_us, dht_scale_pct, st.dht_reads);
+        printf("  \"dht_fail_fixed\": %lu, \"dht_fail_first\": %lu, \"dht_fail\": %lu,\n",
+               st.dht_fail_fixed, st.dht_fail_first, st.dht_fail);
+        printf("  \"dht_retries\": %lu\n", st.dht_retries);
+        printf("}\n");
+    } else {
+        printf("dht11 decoder      reads %lu (jitter %d us, sensor clock %d%%)\n",
+               st.dht_reads, dht_jitter_us, dht_scale_pct);
+        printf("  fixed 49us       fail %lu (%.2f%%)\n",
+               st.dht_fail_fixed, 100.0 * st.dht_fail_fixed / st.dht_reads);
+        printf("  calibrated       fail %lu (%.2f%%)\n",
+               st.dht_fail_first, 100.0 * st.dht_fail_first / st.dht_reads);
+        printf("  + retries        fail %lu (%.2f%%), retries %lu\n",
+               st.dht_fail, 100.0 * st.dht_fail / st.dht_reads, st.dht_retries);
+    }
+    return 0;
+}
+
+// app이 보낸 flush 요청의 시작/끝 시각 (이벤트 → 화면 반영 지연 측정용)
+static uint64_t tick_pending, enc_pending;
+
+/*
+ * flush 한 번 (write() 경로: 전체, mmap 경로: ioctl 영역)
+ * 드라이버 인코딩 → SSD1306 모델, 요청 영역의 GDDRAM이 app 화면과 같은지 확인
+ */
+static void sim_oled_flush(const unsigned char *fb, const oled_rect_t *rc) {
+    unsigned long before = oled.bytes;
+    uint64_t t = now_ns();
+    int p;
+
+    oled_flush_rect(fb, rc->col, rc->page, rc->width, rc->pages);
+    sample_add(&st.bus_bytes, oled.bytes - before);
+    for (p = rc->page; p < rc->page + rc->pages; p++) {
+        if (memcmp(&oled.ram[p][rc->col], fb + p * OLED_WIDTH + rc->col, rc->width)) {
+            st.mismatches++;
+            break;
+        }
+    }
+
+    st.frames++;
+    if (tick_pending) {
+        sample_add(&st.tick_lat_ns, t - tick_pending);
+        tick_pending = 0;
+    }
+    if (enc_pending) {
+        sample_add(&st.enc_lat_ns, t - enc_pending);
+        enc_pending = 0;
+    }
+}
+
+static void print_pct_json(const char *ind, const char *name, samples_t *s, double div) {
+    printf("%s\"%s\": {\"n\": %d, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f},\n",
+           ind, name, s->n, sample_pct(s, 50) / div, sample_pct(s, 90) / div,
+           sample_pct(s, 99) / div, sample_pct(s, 100) / div);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-T] [-J] [-W] [-L preload.so] [-t seconds] [-p tick_ms] [-j jitter_us]\n"
+                    "          [-s sensor_clock_pct] [-e enc_ms] [-D dht_reads] [app_path]\n", prog);
+    exit(2);
+}
+
+// 유저앱과 주고받는 pty를 raw 모드로 (바이너리 구조체가 그대로 지나가도록)
+static int open_raw_pty(char *slave_name, size_t len, int *slave_fd) {
+    struct termios tio;
+    int m = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (m < 0 || grantpt(m) || unlockpt(m)) return -1;
+    snprintf(slave_name, len, "%s", ptsname(m));
+
+    // 앱이 나가도 pty가 닫히지 않도록 시뮬레이터도 slave를 하나 쥐고 있음
+    *slave_fd = open(slave_name, O_RDWR | O_NOCTTY);
+    if (*slave_fd < 0) return -1;
+    tcgetattr(*slave_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(*slave_fd, TCSANOW, &tio);
+    return m;
+}
+
+static void arm_periodic(int tfd, long ms) {
+    struct itimerspec its;
+
+    its.it_value.tv_sec = ms / 1000;
+    its.it_value.tv_nsec = (ms % 1000) * 1000000L;
+    its.it_interval = its.it_value;
+    timerfd_settime(tfd, 0, &its, NULL);
+}
+
+int main(int argc, char **argv) {
+    int duration_s = 10, tick_ms = 1000, enc_ms = 0, json = 0, dht_only = 0;
+    int use_mmap = 1;                          // -W: app이 write()로 보내는 예전 경로
+    const char *app = "./app", *preload = "./hw_sim_preload.so";
+    char preload_abs[PATH_MAX], sock_str[16];
+    unsigned char *oled_map = NULL;
+    int sv[2] = { -1, -1 };
+    char dir[] = "/tmp/hw_sim.XXXXXX";
+    char oled_path[64], dht_path[64], pty_name[64];
+    int clock_m, clock_s, oled_fd, dht_fd, tick_fd, dht_tfd, enc_fd;
+    unsigned char frame[1024];
+    int frame_len = 0;
+    uint64_t start_ns, end_ns, busy;
+    clock_info_t cur = { 0 };
+    int enc_step = 0;
+    int hum = 45, temp = 23;
+    pid_t pid;
+    int opt, status;
+    struct rusage ru;
+
+    while ((opt = getopt(argc, argv, "JWTL:t:p:j:s:e:D:")) != -1) {
+        switch (opt) {
+        case 'J': json = 1; break;
+        case 'W': use_mmap = 0; break;
+        case 'T': return self_test();
+        case 'L': preload = optarg; break;
+        case 't': duration_s = atoi(optarg); break;
+        case 'p': tick_ms = atoi(optarg); break;
+        case 'j': dht_jitter_us = atoi(optarg); break;
+        case 's': dht_scale_pct = atoi(optarg); break;
+        case 'D': dht_only = atoi(optarg); break;
+        case 'e': enc_ms = atoi(optarg); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (optind < argc) app = argv[optind];
+    if (tick_ms <= 0) usage(argv[0]);
+    if (enc_ms <= 0) enc_ms = tick_ms * 3 / 2;  // 초 경계와 겹치지 않는 주기
+
+    if (dht_scale_pct <= 0) usage(argv[0]);
+
+    srand(1);
+    if (dht_only > 0)
+        return dht_only_run(dht_only, json);
+    signal(SIGPIPE, SIG_IGN);
+
+    // DS1302 초기값: 2024-01-01 12:00:00, WP ON
+    ds.reg[0] = 0x00; ds.reg[1] = 0x00; ds.reg[2] = 0x12;
+    ds.reg[3] = 0x01; ds.reg[4] = 0x01; ds.reg[5] = 0x01; ds.reg[6] = 0x24; ds.reg[7] = 0x80;
+
+    // DS1302 트랜잭션 1회 비용 (드라이버 udelay 합계, 버스 상태는 바꾸지 않음)
+    busy = ds_busy_us;
+    rtc_read_clock(&cur);
+    st.ds_read_us = ds_busy_us - busy;
+    busy = ds_busy_us;
+    rtc_write_clock(&cur);
+    st.ds_write_us = ds_busy_us - busy;
+
+    // 디바이스 대용 파일
+    if (!mkdtemp(dir)) { perror("mkdtemp"); return 1; }
+    snprintf(oled_path, sizeof(oled_path), "%s/my_oled", dir);
+    snprintf(dht_path, sizeof(dht_path), "%s/dht11_driver", dir);
+    if (mkfifo(dht_path, 0600)) { perror("mkfifo"); return 1; }
+
+    /*
+     * /dev/my_oled 대용
+     * mmap 경로(기본): 1024바이트 일반 파일 → app의 mmap()이 그대로 성공하고,
+     *   FLUSH/FLUSH_RECT ioctl은 hw_sim_preload.so가 소켓으로 넘겨 줌 (app의 present() 경로 그대로)
+     * write 경로(-W 또는 preload 없음): FIFO로 1024바이트 프레임을 받음
+     */
+    if (use_mmap && !realpath(preload, preload_abs)) {
+        fprintf(stderr, "%s not found, falling back to the write() path\n", preload);
+        use_mmap = 0;
+    }
+    if (use_mmap) {
+        int f = open(oled_path, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (f < 0 || ftruncate(f, OLED_FB_SIZE)) { perror("oled file"); return 1; }
+        oled_map = mmap(NULL, OLED_FB_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+        close(f);
+        if (oled_map == MAP_FAILED) { perror("mmap"); return 1; }
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv)) { perror("socketpair"); return 1; }
+        oled_fd = sv[0];
+        snprintf(sock_str, sizeof(sock_str), "%d", sv[1]);
+    } else {
+        if (mkfifo(oled_path, 0600)) { perror("mkfifo"); return 1; }
+        // O_RDWR: 앱이 열기 전에도 막히지 않음
+        oled_fd = open(oled_path, O_RDWR | O_NONBLOCK);
+    }
+    dht_fd = open(dht_path, O_RDWR | O_NONBLOCK);
+    clock_m = open_raw_pty(pty_name, sizeof(pty_name), &clock_s);
+    if (oled_fd < 0 || dht_fd < 0 || clock_m < 0) { perror("sim devices"); return 1; }
+
+    pid = fork();
+    if (pid == 0) {
+        setenv("SMARTCLOCK_OLED_DEV", oled_path, 1);
+        setenv("SMARTCLOCK_CLOCK_DEV", pty_name, 1);
+        setenv("SMARTCLOCK_DHT_DEV", dht_path, 1);
+        if (use_mmap) {
+            close(sv[0]);
+            setenv("HW_SIM_OLED_SOCK", sock_str, 1);
+            setenv("LD_PRELOAD", preload_abs, 1);
+        }
+        // 앱 로그는 측정 결과와 섞이지 않게 버림
+        freopen("/dev/null", "w", stdout);
+        execl(app, app, (char *)NULL);
+        perror("exec app");
+        _exit(127);
+    }
+    if (use_mmap)
+        close(sv[1]);
+
+    tick_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    dht_tfd = timerfd_create(CLOCK_MONOTONIC, 0);
+    enc_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    arm_periodic(tick_fd, tick_ms);
+    arm_periodic(dht_tfd, 2 * tick_ms);  // DHT 샘플 주기 2초 (시뮬레이션 시간)
+    arm_periodic(enc_fd, enc_ms);
+
+    start_ns = now_ns();
+    end_ns = start_ns + (uint64_t)duration_s * 1000000000ull;
+
+    while (now_ns() < end_ns) {
+        struct pollfd pfd[5] = {
+            { .fd = clock_m, .events = POLLIN },
+            { .fd = oled_fd, .events = POLLIN },
+            { .fd = tick_fd, .events = POLLIN },
+            { .fd = dht_tfd, .events = POLLIN },
+            { .fd = enc_fd, .events = POLLIN },
+        };
+        uint64_t exp;
+
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            fprintf(stderr, "app exited early (status %d)\n", status);
+            return 1;
+        }
+        if (poll(pfd, 5, 100) <= 0) continue;
+
+        // 앱 → /dev/smart_clock write(): DS1302에 반영 후 상태 알림
+        if (pfd[0].revents & POLLIN) {
+            clock_info_t c;
+            if (read(clock_m, &c, sizeof(c)) == (ssize_t)sizeof(c)) {
+                rtc_write_clock(&c);
+                rtc_read_clock(&cur);
+                write(clock_m, &cur, sizeof(cur));
+            }
+        }
+
+        // 1초 경과: DS1302 진행 → 정상 모드면 드라이버처럼 burst로 읽어서 앱에 전달
+        // (설정 모드에서는 드라이버 시계가 멈춰 있으므로 알림 없음)
+        if (pfd[2].revents & POLLIN) {
+            read(tick_fd, &exp, sizeof(exp));
+            ds_tick();
+            if (cur.mode == 0) {
+                int want_s = BCD2BIN(ds.reg[0] & 0x7F);
+
+                rtc_read_clock(&cur);
+                if (cur.seconds != want_s) st.rtc_errors++;
+
+                write(clock_m, &cur, sizeof(cur));
+                st.ticks++;
+                if (!tick_pending) tick_pending = now_ns();
+            }
+        }
+
+        // 엔코더/버튼 이벤트 한 단계
+        if (pfd[4].revents & POLLIN) {
+            int ev = enc_script[enc_step];
+
+            read(enc_fd, &exp, sizeof(exp));
+            enc_step = (enc_step + 1) % ENC_SCRIPT_LEN;
+
+            if (ev == 0) {
+                cur.mode = (cur.mode + 1) % 3;
+                if (cur.mode == 0) {
+                    // 설정 종료: 모아 둔 편집을 한 번에 기록
+                    rtc_write_clock(&cur);
+                }
+            } else if (cur.mode == 1) {
+                cur.hours = ((cur.hours + ev) % 24 + 24) % 24;
+            } else if (cur.mode == 2) {
+                cur.minutes = ((cur.minutes + ev) % 60 + 60) % 60;
+                cur.seconds = 0;
+            }
+
+            write(clock_m, &cur, sizeof(cur));
+            st.encoder_events++;
+            if (!enc_pending) enc_pending = now_ns();
+        }
+
+        // DHT11 샘플: 파형 생성 → 드라이버 규칙으로 디코딩(+재시도) → 성공하면 앱에 전달
+        if (pfd[3].revents & POLLIN) {
+            unsigned char data[5], out[5];
+
+            read(dht_tfd, &exp, sizeof(exp));
+            hum += rand() % 3 - 1;
+            temp += rand() % 3 - 1;
+            data[0] = hum; data[1] = 0; data[2] = temp; data[3] = 0;
+            data[4] = data[0] + data[1] + data[2] + data[3];
+
+            if (dht_sim_sample(data, out) == 0) {
+                dht11_info_t di = { out[0], out[2] };
+                write(dht_fd, &di, sizeof(di));
+            }
+        }
+
+        // 앱 → /dev/my_oled: 드라이버 인코딩 → SSD1306 모델
+        if ((pfd[1].revents & POLLIN) && use_mmap) {
+            // ioctl 한 번: app은 응답을 받을 때까지 ioctl()에서 기다림 (드라이버의 동기 flush와 같음)
+            sim_oled_req_t req;
+            oled_rect_t full = { 0, 0, OLED_WIDTH, OLED_PAGES };
+            int ret = 0;
+
+            if (recv(oled_fd, &req, sizeof(req), 0) == (ssize_t)sizeof(req)) {
+                const oled_rect_t *rc = (req.cmd == OLED_IOC_FLUSH) ? &full : &req.rect;
+
+                if (!oled_rect_valid(rc))
+                    ret = -EINVAL;
+                else
+                    sim_oled_flush(oled_map, rc);
+                send(oled_fd, &ret, sizeof(ret), 0);
+            }
+        } else if (pfd[1].revents & POLLIN) {
+            oled_rect_t full = { 0, 0, OLED_WIDTH, OLED_PAGES };
+            ssize_t r;
+
+            while ((r = read(oled_fd, frame + frame_len, sizeof(frame) - frame_len)) > 0) {
+                frame_len += r;
+                if (frame_len < (int)sizeof(frame)) continue;
+
+                sim_oled_flush(frame, &full);
+                frame_len = 0;
+            }
+        }
+    }
+
+    kill(pid, SIGTERM);
+    wait4(pid, &status, 0, &ru);
+
+    double elapsed_s = (now_ns() - start_ns) / 1e9;
+    uint64_t cpu_us = (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+                      ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+    uint64_t bus_total = sample_sum(&st.bus_bytes);
+
+    if (json) {
+        // 커밋 간 비교용: 키 이름/순서 고정
+        // 최상위 = 이번 실행에서 잰 값, "modeled" = 상수/공식으로 계산한 추정치 (실측 아님)
+        printf("{\n");
+        printf("  \"duration_s\": %d, \"tick_ms\": %d, \"encoder_ms\": %d, \"dht_jitter_us\": %d,\n",
+               duration_s, tick_ms, enc_ms, dht_jitter_us);
+        printf("  \"oled_path\": \"%s\",\n", use_mmap ? "mmap" : "write");
+        printf("  \"frames\": %lu, \"frames_per_s\": %.2f,\n", st.frames, st.frames / elapsed_s);
+        print_pct_json("  ", "tick_to_frame_us", &st.tick_lat_ns, 1000.0);
+        // 엔코더는 드라이버 디코더가 아니라 시뮬레이터 스크립트가 바꾼 상태를 보낸 시점부터
+        print_pct_json("  ", "encoder_state_to_frame_us", &st.enc_lat_ns, 1000.0);
+        print_pct_json("  ", "bus_bytes_per_frame", &st.bus_bytes, 1.0);
+        printf("  \"app_cpu_us_per_frame\": %.1f,\n", st.frames ? (double)cpu_us / st.frames : 0.0);
+        printf("  \"ds1302_transactions\": %lu,\n", ds.transactions);
+        printf("  \"dht_reads\": %lu, \"dht_fail\": %lu, \"dht_fail_fixed\": %lu, \"dht_retries\": %lu,\n",
+               st.dht_reads, st.dht_fail, st.dht_fail_fixed, st.dht_retries);
+        printf("  \"ssd1306_mismatch\": %lu, \"ds1302_errors\": %lu,\n", st.mismatches, st.rtc_errors);
+        printf("  \"modeled\": {\n");
+        // 버스 바이트 x 400kHz 바이트 시간
+        print_pct_json("    ", "bus_us_per_frame_400khz", &st.bus_bytes, 1000.0 / I2C_NS_PER_BYTE);
+        // 시작 신호 20ms + 30us + 생성한 파형 길이 (폴링 드라이버가 IRQ를 끄는 구간)
+        print_pct_json("    ", "dht_irqoff_us_polled", &st.dht_irqoff_us, 1.0);
+        // 트랜잭션 1회의 드라이버 udelay 합 (GPIO 접근 시간 제외)
+        printf("    \"ds1302_read_us\": %llu, \"ds1302_write_us\": %llu\n",
+               (unsigned long long)st.ds_read_us, (unsigned long long)st.ds_write_us);
+        printf("  }\n");
+        printf("}\n");
+    } else {
+        printf("duration_s         %d (tick %d ms, encoder %d ms)\n", duration_s, tick_ms, enc_ms);
+        printf("clock_ticks        %lu, encoder_events %lu\n", st.ticks, st.encoder_events);
+        printf("frames             %lu (%.2f/s, %s)\n", st.frames, st.frames / elapsed_s,
+               use_mmap ? "mmap + FLUSH_RECT" : "write");
+        printf("tick_to_frame_us   p50 %.1f p99 %.1f max %.1f\n",
+               sample_pct(&st.tick_lat_ns, 50) / 1000.0, sample_pct(&st.tick_lat_ns, 99) / 1000.0,
+               sample_pct(&st.tick_lat_ns, 100) / 1000.0);
+        printf("enc_state_to_frame_us p50 %.1f p99 %.1f max %.1f\n",
+               sample_pct(&st.enc_lat_ns, 50) / 1000.0, sample_pct(&st.enc_lat_ns, 99) / 1000.0,
+               sample_pct(&st.enc_lat_ns, 100) / 1000.0);
+        printf("bus_bytes          total %llu per_frame %llu max %llu (msgs %lu)\n",
+               (unsigned long long)bus_total,
+               (unsigned long long)(st.frames ? bus_total / st.frames : 0),
+               (unsigned long long)sample_pct(&st.bus_bytes, 100), oled.msgs);
+        printf("app_cpu_ms         user %ld sys %ld\n",
+               ru.ru_utime.tv_sec * 1000 + ru.ru_utime.tv_usec / 1000,
+               ru.ru_stime.tv_sec * 1000 + ru.ru_stime.tv_usec / 1000);
+        printf("ssd1306_mismatch   %lu\n", st.mismatches);
+        printf("ds1302             transactions %lu errors %lu (modeled: read %llu us, write %llu us)\n",
+               ds.transactions, st.rtc_errors,
+               (unsigned long long)st.ds_read_us, (unsigned long long)st.ds_write_us);
+        printf("dht11              reads %lu fail %lu (fixed-threshold %lu, retries %lu, "
+               "jitter %d us, modeled polled irq-off p50 %llu us)\n",
+               st.dht_reads, st.dht_fail, st.dht_fail_fixed, st.dht_retries, dht_jitter_us,
+               (unsigned long long)sample_pct(&st.dht_irqoff_us, 50));
+    }
+
+    close(clock_s);
+    close(clock_m);
+    close(oled_fd);
+    close(dht_fd);
+    if (oled_map)
+        munmap(oled_map, OLED_FB_SIZE);
+    unlink(oled_path);
+    unlink(dht_path);
+    rmdir(dir);
+
+    return (st.mismatches || st.rtc_errors) ? 1 : 0;
+}
@@ -0,0 +1,14 @@
+// hw_sim.h
+// hw_sim.c와 hw_sim_preload.c가 소켓으로 주고받는 요청 (둘이 같이 사용)
+// 포함하기 전에 oled_ssd1306.h 필요 (oled_rect_t)
+
+#ifndef _HW_SIM_H
+#define _HW_SIM_H
+
+// hw_sim_preload.so → hw_sim ioctl 요청: cmd가 OLED_IOC_FLUSH_RECT일 때만 rect 사용
+typedef struct {
+    unsigned long cmd;
+    oled_rect_t rect;
+} sim_oled_req_t;
+
+#endif /* _HW_SIM_H */
@@ -0,0 +1,86 @@
+// hw_sim_preload.c
+// hw_sim이 app에 LD_PRELOAD로 넣는 ioctl 가로채기
+//
+// hw_sim은 /dev/my_oled 대신 1024바이트 일반 파일을 넘기므로 app의 mmap()은 그대로 성공하고,
+// 그 파일에 대한 OLED_IOC_FLUSH / OLED_IOC_FLUSH_RECT만 여기서 잡아서
+// HW_SIM_OLED_SOCK 소켓으로 hw_sim에 넘긴 뒤 드라이버처럼 처리가 끝날 때까지 기다린다.
+// 그 밖의 ioctl은 libc로 그대로 넘김
+//
+// 빌드: gcc -O2 -Wall -shared -fPIC -o hw_sim_preload.so hw_sim_preload.c -ldl
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include "oled_ssd1306.h"
+#include "hw_sim.h"       // hw_sim과 주고받는 sim_oled_req_t
+
+static int (*real_ioctl)(int, unsigned long, ...);
+static int oled_sock = -2;           // -2: 아직 확인 안 함, -1: hw_sim 밖에서 실행
+static dev_t oled_dev;
+static ino_t oled_ino;
+
+static void sim_init(void)
+{
+    const char *sock = getenv("HW_SIM_OLED_SOCK");
+    const char *path = getenv("SMARTCLOCK_OLED_DEV");
+    struct stat st;
+
+    real_ioctl = dlsym(RTLD_NEXT, "ioctl");
+    oled_sock = -1;
+    if (!sock || !path || stat(path, &st))
+        return;
+
+    oled_dev = st.st_dev;
+    oled_ino = st.st_ino;
+    oled_sock = atoi(sock);
+}
+
+static int is_sim_oled(int fd)
+{
+    struct stat st;
+
+    return oled_sock >= 0 && !fstat(fd, &st) &&
+           st.st_dev == oled_dev && st.st_ino == oled_ino;
+}
+
+int ioctl(int fd, unsigned long req, ...)
+{
+    va_list ap;
+    void *arg;
+    sim_oled_req_t r = { .cmd = req };
+    int ret;
+
+    va_start(ap, req);
+    arg = va_arg(ap, void *);
+    va_end(ap);
+
+    if (oled_sock == -2)
+        sim_init();
+
+    if ((req == OLED_IOC_FLUSH || req == OLED_IOC_FLUSH_RECT) && is_sim_oled(fd)) {
+        if (req == OLED_IOC_FLUSH_RECT)
+            r.rect = *(const oled_rect_t *)arg;
+
+        // 요청 → hw_sim이 SSD1306 모델로 전송을 끝내고 드라이버 리턴값(0 / -errno)을 돌려줌
+        if (send(oled_sock, &r, sizeof(r), 0) != (ssize_t)sizeof(r) ||
+            recv(oled_sock, &ret, sizeof(ret), 0) != (ssize_t)sizeof(ret)) {
+            errno = EIO;
+            return -1;
+        }
+        if (ret < 0) {
+            errno = -ret;
+            return -1;
+        }
+        return 0;
+    }
+
+    return real_ioctl(fd, req, arg);
+}
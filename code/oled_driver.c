@@ -6,6 +6,19 @@
 #include <linux/i2c.h>        // I2C 서브시스템 (i2c_adapter, i2c_client)
 #include <linux/cdev.h>       // 문자 디바이스 구조체 (이번 코드는 register_chrdev만 사용)
 #include <linux/slab.h>       // kmalloc, kfree (커널 동적 메모리 할당)
+#include <linux/mm.h>         // mmap (remap_pfn_range), 페이지 할당
+#include <linux/mutex.h>      // 섀도 버퍼 / I2C 전송 직렬화
+#include <linux/debugfs.h>    // 전송/스킵 바이트 통계 노출
+#include <linux/workqueue.h>  // 비동기(O_NONBLOCK) 프레임 전송 워커
+#include <linux/ktime.h>      // 초기화/전송 소요 시간 측정
+#include <linux/fb.h>         // fbdev(/dev/fbN) deferred io 백엔드
+#include <linux/spinlock.h>   // fbdev 손상(damage) 영역 보호
+#include <linux/percpu.h>     // 통계 카운터 (CPU별, 락 없음)
+#include <linux/seq_file.h>   // debugfs stats 파일
+#include <linux/log2.h>       // 전송 시간 히스토그램 구간 (2의 거듭제곱 us)
+
+#define CREATE_TRACE_POINTS
+#include "oled_trace.h"       // my_oled:* tracepoint (write/flush/I2C 에러)
 
 #define DRIVER_NAME "my_oled" // /dev/my_oled 디바이스 이름
 #define DRIVER_MAJOR 231      // 문자 디바이스 메이저 번호 (고정 사용)
@@ -16,6 +29,12 @@
 // 라즈베리파이 기본 I2C 버스 번호 (/dev/i2c-1)
 #define I2C_BUS_NUM   1
 
+// 화면 크기, oled_rect_t/ioctl 번호, 초기화 테이블, 창/diff 인코딩 (hw_sim.c와 공용)
+#include "oled_ssd1306.h"
+
+// 초기화 테이블의 기본 contrast 값
+#define OLED_DEFAULT_CONTRAST 0xCF
+
 // I2C 버스를 나타내는 구조체 포인터
 static struct i2c_adapter *oled_i2c_adapter = NULL;
 
@@ -23,92 +42,332 @@ static struct i2c_adapter *oled_i2c_adapter = NULL;
 static struct i2c_client *oled_i2c_client = NULL;
 
 /*
- * SSD1306 초기화 명령어 테이블
- * open() 시 한 바이트씩 I2C Command로 전송됨
- */
-static const unsigned char oled_init_cmds[] = {
-    0xAE,       // Display OFF
-    0x00,       // Set lower column start address
-    0x10,       // Set higher column start address
-    0x40,       // Set display start line
-    0x81, 0xCF, // Set contrast
-    0xA1,       // Segment remap (좌우 반전)
-    0xC8,       // COM scan direction (상하 반전)
-    0xA6,       // Normal display (반전 아님)
-    0xA8, 0x3F, // Multiplex ratio (1/64)
-    0xD3, 0x00, // Display offset
-    0xD5, 0x80, // Display clock divide ratio
-    0xD9, 0xF1, // Pre-charge period
-    0xDA, 0x12, // COM pins hardware configuration
-    0xDB, 0x40, // VCOMH deselect level
-    0x20, 0x00, // Memory addressing mode = Horizontal
-    0x8D, 0x14, // Charge pump enable
-    0xAF        // Display ON
+ * 커널 프레임버퍼 (mmap으로 유저에게 그대로 노출, 1페이지)
+ * 전송 중에도 유저가 바꿀 수 있으므로 I2C로 직접 보내지 않고 항상 떠 둔 사본을 보낸다
+ */
+static unsigned char *oled_fb = NULL;
+
+/*
+ * 한 번의 i2c_transfer()로 보낼 메시지들
+ * 페이지마다 [창 설정 명령 메시지][데이터 메시지] 쌍 → 최대 8쌍
+ * 메시지 사이에는 STOP 없이 repeated START만 들어간다
+ */
+static unsigned char oled_win_buf[OLED_PAGES][7];              // 0x00 + 0x21 c0 c1 + 0x22 p0 p1
+static unsigned char oled_span_buf[OLED_PAGES][OLED_WIDTH + 1]; // 0x40 + 한 페이지 최대 128바이트
+static struct i2c_msg oled_msgs[OLED_PAGES * 2];
+
+/*
+ * 마지막으로 패널에 보낸 프레임의 사본(섀도 버퍼)
+ * 새 프레임과 페이지 단위로 비교해서 바뀐 컬럼 구간만 전송한다.
+ * oled_shadow_valid가 false면 패널 내용을 모르는 상태 → 전체 전송
+ */
+static unsigned char oled_shadow_buf[1 + OLED_FB_SIZE] = { 0x40 }; // 0x40 + 프레임 (전체 전송용)
+static unsigned char * const oled_shadow = oled_shadow_buf + 1;
+static bool oled_shadow_valid = false;
+
+/*
+ * 패널 상태
+ * 초기화는 모듈 로드 시 한 번만 하고, 이후에는 RESET ioctl이나
+ * I2C 에러(initialized = 0)가 났을 때만 다시 한다.
+ * I2C 에러가 나면 섀도 버퍼도 무효화해서 재초기화 뒤 첫 flush는 전체 전송.
+ */
+static oled_state_t oled_state = {
+    .initialized = 0,
+    .display_on  = 1,
+    .contrast    = OLED_DEFAULT_CONTRAST,
 };
 
+// 섀도 버퍼, 패널 상태, I2C 전송을 보호하는 락
+static DEFINE_MUTEX(oled_lock);
+
+/*
+ * O_NONBLOCK write용 대기 프레임
+ * write()는 여기에 복사만 하고 바로 리턴, 실제 전송은 oled_wq 워커가 담당.
+ * 워커가 가져가기 전에 새 프레임이 오면 덮어씀 (latest wins)
+ */
+static unsigned char oled_pending[OLED_FB_SIZE];
+static unsigned char oled_pending_in[OLED_FB_SIZE]; // 유저 복사용, 다 받은 뒤에만 oled_pending에 반영
+static int oled_pending_len = 0;              // 0이면 대기 프레임 없음
+static int oled_async_err = 0;                // 워커 전송 에러 (fsync에서 보고)
+static DEFINE_MUTEX(oled_pending_lock);
+
+static struct workqueue_struct *oled_wq = NULL;
+static struct work_struct oled_flush_work;
+
 /*
- * SSD1306에 "명령(Command)" 1바이트를 I2C로 전송
+ * debugfs 통계 (/sys/kernel/debug/my_oled/stats)
+ * CPU별 카운터라 증가할 때 락/원자 연산이 없음. 읽을 때만 모든 CPU 값을 합산
  */
-static int oled_i2c_write_cmd(unsigned char cmd)
+static struct dentry *oled_debugfs_dir = NULL;
+
+enum {
+    OLED_STAT_FRAMES_SUBMITTED,     // write()로 제출된 프레임
+    OLED_STAT_FRAMES_COALESCED,     // 전송 전에 다음 프레임으로 덮어써진 프레임
+    OLED_STAT_FRAMES_TRANSMITTED,   // 실제 패널까지 전송된 프레임
+    OLED_STAT_BYTES_SENT,           // 실제 전송한 픽셀 바이트
+    OLED_STAT_BYTES_SKIPPED,        // 변경이 없어 생략한 바이트
+    OLED_STAT_I2C_ERRORS,           // i2c_master_send / i2c_transfer 실패
+    OLED_STAT_NR
+};
+
+static const char * const oled_stat_names[OLED_STAT_NR] = {
+    "frames_submitted", "frames_coalesced", "frames_transmitted",
+    "bytes_sent", "bytes_skipped", "i2c_errors",
+};
+
+// 프레임 전송 시간 히스토그램: 구간 i = [2^i, 2^(i+1)) us, 마지막 구간은 그 이상 전부
+#define OLED_FLUSH_BUCKETS 16
+
+struct oled_stats {
+    u64 cnt[OLED_STAT_NR];
+    u64 flush_us[OLED_FLUSH_BUCKETS];
+};
+
+static DEFINE_PER_CPU(struct oled_stats, oled_stats);
+
+#define oled_stat_inc(i)    this_cpu_inc(oled_stats.cnt[i])
+#define oled_stat_add(i, n) this_cpu_add(oled_stats.cnt[i], n)
+
+// debugfs 통계: 마지막 초기화 / 마지막 프레임 전송에 걸린 시간 (ns)
+static u64 oled_init_ns = 0;
+static u64 oled_flush_ns = 0;
+
+// 프레임 전송 시간 1회를 히스토그램에 기록 (CPU별)
+static void oled_flush_hist(u64 ns)
 {
-    // SSD1306 I2C 프로토콜:
-    // 첫 바이트 0x00 → Command
-    unsigned char buf[2] = {0x00, cmd};
+    u64 us = div_u64(ns, NSEC_PER_USEC);
+    int b = us ? min_t(int, ilog2(us), OLED_FLUSH_BUCKETS - 1) : 0;
 
-    // I2C로 2바이트 전송
-    if (i2c_master_send(oled_i2c_client, buf, 2) != 2) {
-        pr_err("OLED: Failed to send command 0x%02X\n", cmd);
+    this_cpu_inc(oled_stats.flush_us[b]);
+}
+
+// /sys/kernel/debug/my_oled/stats: 모든 CPU 카운터 합산
+static int oled_stats_show(struct seq_file *m, void *v)
+{
+    u64 cnt[OLED_STAT_NR] = {0}, hist[OLED_FLUSH_BUCKETS] = {0};
+    int cpu, i;
+
+    for_each_possible_cpu(cpu) {
+        const struct oled_stats *st = per_cpu_ptr(&oled_stats, cpu);
+
+        for (i = 0; i < OLED_STAT_NR; i++)
+            cnt[i] += st->cnt[i];
+        for (i = 0; i < OLED_FLUSH_BUCKETS; i++)
+            hist[i] += st->flush_us[i];
+    }
+
+    for (i = 0; i < OLED_STAT_NR; i++)
+        seq_printf(m, "%-20s %llu\n", oled_stat_names[i], (unsigned long long)cnt[i]);
+
+    seq_puts(m, "flush_us:\n");
+    for (i = 0; i < OLED_FLUSH_BUCKETS; i++) {
+        if (!hist[i])
+            continue;
+        if (i == 0)
+            seq_printf(m, "  %8s %7u us: %llu\n", "<", 2, (unsigned long long)hist[i]);
+        else if (i == OLED_FLUSH_BUCKETS - 1)
+            seq_printf(m, "  %8s %7lu us: %llu\n", ">=", 1UL << i, (unsigned long long)hist[i]);
+        else
+            seq_printf(m, "  %8lu-%7lu us: %llu\n", 1UL << i, (1UL << (i + 1)) - 1,
+                       (unsigned long long)hist[i]);
+    }
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(oled_stats);
+
+/*
+ * SSD1306에 "명령(Command)" 여러 바이트를 I2C 메시지 하나로 전송
+ * 0x00 컨트롤 바이트 뒤의 바이트들은 모두 명령으로 해석된다 (Co = 0)
+ */
+static int oled_i2c_write_cmds(const unsigned char *cmds, int len)
+{
+    unsigned char buf[32];
+    int ret;
+
+    if (len > sizeof(buf) - 1)
+        return -EINVAL;
+
+    // SSD1306 I2C 프로토콜:
+    // 첫 바이트 0x00 → 이후 전부 Command
+    buf[0] = 0x00;
+    memcpy(buf + 1, cmds, len);
+
+    // START/주소/STOP 한 번으로 전송
+    ret = i2c_master_send(oled_i2c_client, buf, len + 1);
+    if (ret != len + 1) {
+        trace_oled_i2c_error(1, len + 1, ret);
+        oled_stat_inc(OLED_STAT_I2C_ERRORS);
+        pr_err("OLED: Failed to send %d command bytes\n", len);
+        // 패널이 리셋됐을 수 있음 → 다음 전송 전에 재초기화, 섀도도 믿을 수 없으므로 전체 전송
+        oled_state.initialized = 0;
+        oled_shadow_valid = false;
         return -EIO; // I/O 에러
     }
     return 0;
 }
 
 /*
- * SSD1306에 "데이터(Data)" 블록을 I2C로 전송
- * 화면 픽셀 데이터용
+ * [창 설정 명령][픽셀 데이터] 메시지 쌍 하나를 채움
+ * win: 채워 둔 창 설정 명령 버퍼 (7바이트), data: 0x40으로 시작하는 데이터 버퍼
  */
-static int oled_i2c_write_data(unsigned char *data, int len)
+static void oled_fill_msgs(struct i2c_msg *msgs, unsigned char *win,
+                           unsigned char *data, int len)
 {
-    unsigned char *buf;
+    msgs[0].addr  = oled_i2c_client->addr;
+    msgs[0].flags = 0;
+    msgs[0].len   = 7;
+    msgs[0].buf   = win;
+
+    msgs[1].addr  = oled_i2c_client->addr;
+    msgs[1].flags = 0;
+    msgs[1].len   = len + 1;
+    msgs[1].buf   = data;
+}
+
+/*
+ * 모아 둔 메시지들을 i2c_transfer() 한 번으로 전송
+ */
+static int oled_i2c_transfer(int num)
+{
+    int i, bytes = 0;
+    int ret = i2c_transfer(oled_i2c_client->adapter, oled_msgs, num);
+
+    if (ret != num) {
+        for (i = 0; i < num; i++)
+            bytes += oled_msgs[i].len;
+        trace_oled_i2c_error(num, bytes, ret);
+        oled_stat_inc(OLED_STAT_I2C_ERRORS);
+        pr_err("OLED: Failed to transfer %d messages\n", num);
+        oled_state.initialized = 0;
+        oled_shadow_valid = false;
+        return -EIO;
+    }
+    return 0;
+}
+
+/*
+ * SSD1306 초기화 (oled_lock을 잡은 상태에서 호출)
+ * 초기화 테이블 전송 후, 바꿔 둔 contrast / Display OFF 상태를 복원
+ */
+static int oled_panel_init(void)
+{
+    unsigned char cmds[3];
+    ktime_t start = ktime_get();
+    int n = 0;
     int ret;
 
-    // 데이터 앞에 컨트롤 바이트(0x40)를 붙이기 위해 len+1 할당
-    buf = kmalloc(len + 1, GFP_KERNEL);
-    if (!buf)
-        return -ENOMEM;
+    // SSD1306 초기화 명령어 전체를 한 번에 전송
+    ret = oled_i2c_write_cmds(oled_init_cmds, sizeof(oled_init_cmds));
+    if (ret < 0)
+        return ret;
 
-    // 0x40 → Data 모드
-    buf[0] = 0x40;
+    if (oled_state.contrast != OLED_DEFAULT_CONTRAST) {
+        cmds[n++] = 0x81;
+        cmds[n++] = oled_state.contrast;
+    }
+    if (!oled_state.display_on)
+        cmds[n++] = 0xAE;
+    if (n) {
+        ret = oled_i2c_write_cmds(cmds, n);
+        if (ret < 0)
+            return ret;
+    }
 
-    // 유저 데이터 복사
-    memcpy(buf + 1, data, len);
+    oled_state.initialized = 1;
+    oled_init_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+    pr_info("OLED: panel initialized\n");
+    return 0;
+}
 
-    // I2C로 한 번에 전송
-    if (i2c_master_send(oled_i2c_client, buf, len + 1) != len + 1) {
-        pr_err("OLED: Failed to send data\n");
-        ret = -EIO;
-    } else {
-        ret = len;
+/*
+ * 프레임버퍼의 지정 영역을 섀도 버퍼와 비교해서 바뀐 부분만 전송
+ * 페이지마다 처음/마지막으로 달라진 컬럼을 찾아 그 구간만 0x21/0x22 창으로 보낸다.
+ * 모든 페이지의 창 설정 + 데이터는 i2c_transfer() 한 번으로 묶어서 전송.
+ * 패널 내용을 모르는 상태(oled_shadow_valid == false)면 영역과 상관없이 전체 전송.
+ * oled_lock을 잡은 상태에서 호출해야 함
+ */
+static int oled_flush(int col, int page, int width, int pages)
+{
+    oled_spans_t sp;
+    int i, p;
+    ktime_t start = ktime_get();
+    int ret;
+
+    // 이전 I2C 에러로 패널 상태를 모르면 먼저 재초기화
+    if (!oled_state.initialized) {
+        ret = oled_panel_init();
+        if (ret < 0)
+            return ret;
     }
 
-    kfree(buf);
-    return ret;
+    if (!oled_shadow_valid) {
+        // 먼저 섀도에 떠 두고 그 사본을 전송 (전송 도중 mmap 쪽에서 바뀌어도 섀도 = 패널)
+        // 섀도 앞에 0x40이 붙어 있으므로 1025바이트 그대로 전송
+        oled_encode_full(oled_fb, oled_shadow, oled_win_buf[0]);
+        oled_fill_msgs(oled_msgs, oled_win_buf[0], oled_shadow_buf, OLED_FB_SIZE);
+        ret = oled_i2c_transfer(2);
+        if (ret < 0)
+            return ret;
+
+        oled_shadow_valid = true;
+        oled_stat_add(OLED_STAT_BYTES_SENT, OLED_FB_SIZE);
+        oled_flush_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+        oled_flush_hist(oled_flush_ns);
+        trace_oled_flush(col, page, width, pages, OLED_FB_SIZE, 0, 2, oled_flush_ns);
+        return 0;
+    }
+
+    // 페이지마다 바뀐 컬럼 구간만 창 설정 + 데이터로 인코딩 (oled_ssd1306.h, hw_sim과 공용)
+    if (oled_encode_spans(oled_fb, oled_shadow, col, page, width, pages,
+                          oled_win_buf, oled_span_buf, &sp)) {
+        for (i = 0; i < sp.n; i++) {
+            p = sp.page[i];
+            oled_fill_msgs(&oled_msgs[i * 2], oled_win_buf[p], oled_span_buf[p], sp.len[i]);
+        }
+
+        ret = oled_i2c_transfer(sp.n * 2);
+        if (ret < 0) {
+            // 패널 상태를 알 수 없으니 다음 프레임은 전체 전송
+            oled_shadow_valid = false;
+            return ret;
+        }
+
+        // 전송이 끝난 구간만 섀도에 반영
+        oled_commit_spans(oled_shadow, oled_span_buf, &sp);
+    }
+
+    oled_stat_add(OLED_STAT_BYTES_SENT, sp.sent);
+    oled_stat_add(OLED_STAT_BYTES_SKIPPED, sp.skipped);
+    oled_flush_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+    oled_flush_hist(oled_flush_ns);
+    trace_oled_flush(col, page, width, pages, sp.sent, sp.skipped, sp.n * 2, oled_flush_ns);
+    return 0;
 }
 
 /*
- * /dev/my_oled open() 호출 시 실행
- * → OLED 초기화 수행
+ * Display ON/OFF 전환 (ioctl, fbdev blank 공용)
  */
-static int oled_open(struct inode *inode, struct file *file)
+static int oled_set_display(int on)
 {
-    int i;
+    unsigned char cmd = on ? 0xAF : 0xAE;
+    int ret;
 
-    pr_info("OLED: Device opened, initializing OLED\n");
+    mutex_lock(&oled_lock);
+    ret = oled_i2c_write_cmds(&cmd, 1);
+    if (ret == 0)
+        oled_state.display_on = on;
+    mutex_unlock(&oled_lock);
 
-    // SSD1306 초기화 명령어 순차 전송
-    for (i = 0; i < sizeof(oled_init_cmds); i++)
-        oled_i2c_write_cmd(oled_init_cmds[i]);
+    return ret;
+}
 
+/*
+ * /dev/my_oled open() 호출 시 실행
+ * → 초기화는 모듈 로드 시 이미 끝났으므로 패널에는 아무것도 보내지 않음
+ *   (모니터링 툴이 잠깐 열었다 닫아도 화면이 깜빡이지 않음)
+ */
+static int oled_open(struct inode *inode, struct file *file)
+{
     return 0;
 }
 
@@ -120,47 +379,225 @@ static int oled_release(struct inode *inode, struct file *file)
     return 0;
 }
 
+/*
+ * 비동기 전송 워커 (oled_wq에서 실행)
+ * 대기 프레임을 프레임버퍼로 옮긴 뒤 전송. 여러 프레임이 쌓였어도 마지막 것만 전송됨
+ */
+static void oled_flush_work_func(struct work_struct *work)
+{
+    int len, ret;
+
+    mutex_lock(&oled_lock);
+
+    mutex_lock(&oled_pending_lock);
+    len = oled_pending_len;
+    oled_pending_len = 0;
+    if (len)
+        memcpy(oled_fb, oled_pending, len);
+    mutex_unlock(&oled_pending_lock);
+
+    if (len) {
+        ret = oled_flush(0, 0, OLED_WIDTH, OLED_PAGES);
+        if (ret < 0)
+            oled_async_err = ret;
+        else
+            oled_stat_inc(OLED_STAT_FRAMES_TRANSMITTED);
+    }
+
+    mutex_unlock(&oled_lock);
+}
+
+/*
+ * O_NONBLOCK write: 대기 프레임에 복사하고 워커에 전송을 맡김
+ * I2C 전송을 기다리지 않으므로 바로 리턴
+ */
+static ssize_t oled_write_async(const char __user *buf, size_t count)
+{
+    mutex_lock(&oled_pending_lock);
+
+    // 복사가 중간에 실패해도 대기 중인 프레임은 그대로 두도록 따로 받은 뒤 반영
+    if (copy_from_user(oled_pending_in, buf, count)) {
+        mutex_unlock(&oled_pending_lock);
+        return -EFAULT;
+    }
+    memcpy(oled_pending, oled_pending_in, count);
+
+    // 아직 전송 안 된 프레임이 있으면 이번 프레임으로 대체됨
+    if (oled_pending_len)
+        oled_stat_inc(OLED_STAT_FRAMES_COALESCED);
+    oled_pending_len = max_t(int, oled_pending_len, count);
+    oled_stat_inc(OLED_STAT_FRAMES_SUBMITTED);
+
+    mutex_unlock(&oled_pending_lock);
+
+    queue_work(oled_wq, &oled_flush_work);
+    return count;
+}
+
 /*
  * /dev/my_oled write() 호출 시 실행
- * → 최대 1024바이트를 OLED 화면에 출력
+ * → 최대 1024바이트를 프레임버퍼에 복사하고 OLED 화면에 출력
+ *   (이전 프레임과 달라진 부분만 전송)
+ *   O_NONBLOCK으로 열었으면 전송을 워커에 맡기고 바로 리턴
  */
 static ssize_t oled_write(struct file *file,
                           const char __user *buf,
                           size_t count,
                           loff_t *f_pos)
 {
-    unsigned char *kbuf;
-    int ret;
+    ssize_t ret;
 
     // SSD1306 128x64 = 1024바이트
-    if (count > 1024)
-        count = 1024;
+    if (count > OLED_FB_SIZE)
+        count = OLED_FB_SIZE;
 
-    // 커널 메모리 할당
-    kbuf = kmalloc(count, GFP_KERNEL);
-    if (!kbuf)
-        return -ENOMEM;
+    trace_oled_write_start(count, !!(file->f_flags & O_NONBLOCK));
+
+    if (file->f_flags & O_NONBLOCK) {
+        ret = oled_write_async(buf, count);
+        trace_oled_write_end(count, ret);
+        return ret;
+    }
 
-    // 유저 공간 → 커널 공간 복사
-    if (copy_from_user(kbuf, buf, count)) {
-        kfree(kbuf);
+    mutex_lock(&oled_lock);
+
+    // 유저 공간 → 커널 프레임버퍼로 바로 복사 (중간 버퍼 없음)
+    if (copy_from_user(oled_fb, buf, count)) {
+        mutex_unlock(&oled_lock);
+        trace_oled_write_end(count, -EFAULT);
         return -EFAULT;
     }
 
-    // 컬럼 주소 설정 (0~127)
-    oled_i2c_write_cmd(0x21);
-    oled_i2c_write_cmd(0);
-    oled_i2c_write_cmd(127);
+    // 이 프레임이 더 최신이므로 아직 전송 안 된 비동기 프레임은 버림
+    mutex_lock(&oled_pending_lock);
+    if (oled_pending_len) {
+        oled_pending_len = 0;
+        oled_stat_inc(OLED_STAT_FRAMES_COALESCED);
+    }
+    oled_stat_inc(OLED_STAT_FRAMES_SUBMITTED);
+    mutex_unlock(&oled_pending_lock);
+
+    // 섀도 버퍼와 비교해서 바뀐 구간만 전송
+    ret = oled_flush(0, 0, OLED_WIDTH, OLED_PAGES);
+    if (ret == 0)
+        oled_stat_inc(OLED_STAT_FRAMES_TRANSMITTED);
+    mutex_unlock(&oled_lock);
+
+    ret = ret < 0 ? ret : count;
+    trace_oled_write_end(count, ret);
+    return ret;
+}
+
+/*
+ * /dev/my_oled fsync() 호출 시 실행
+ * → 비동기로 제출한 프레임이 패널에 전송될 때까지 대기
+ */
+static int oled_fsync(struct file *file, loff_t start, loff_t end, int datasync)
+{
+    int ret;
 
-    // 페이지 주소 설정 (0~7)
-    oled_i2c_write_cmd(0x22);
-    oled_i2c_write_cmd(0);
-    oled_i2c_write_cmd(7);
+    flush_work(&oled_flush_work);
 
-    // 화면 데이터 전송
-    ret = oled_i2c_write_data(kbuf, count);
+    // 워커에서 난 에러는 한 번만 보고
+    mutex_lock(&oled_lock);
+    ret = oled_async_err;
+    oled_async_err = 0;
+    mutex_unlock(&oled_lock);
+
+    return ret;
+}
+
+/*
+ * /dev/my_oled mmap() 호출 시 실행
+ * → 커널 프레임버퍼(1페이지)를 유저 공간에 그대로 매핑
+ *   유저는 매핑된 메모리에 직접 그린 뒤 OLED_IOC_FLUSH(_RECT)로 전송 요청
+ */
+static int oled_mmap(struct file *file, struct vm_area_struct *vma)
+{
+    unsigned long size = vma->vm_end - vma->vm_start;
+
+    // 프레임버퍼 한 페이지만 허용
+    if (vma->vm_pgoff != 0 || size > PAGE_SIZE)
+        return -EINVAL;
+
+    return remap_pfn_range(vma, vma->vm_start,
+                           virt_to_phys(oled_fb) >> PAGE_SHIFT,
+                           size, vma->vm_page_prot);
+}
+
+/*
+ * /dev/my_oled ioctl() 호출 시 실행
+ * → OLED_IOC_FLUSH: 화면 전체, OLED_IOC_FLUSH_RECT: 지정 영역만 전송
+ */
+static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    oled_rect_t rect;
+    oled_state_t state;
+    unsigned char cmds[2];
+    int contrast;
+    int ret;
+
+    switch (cmd) {
+    case OLED_IOC_FLUSH:
+        rect.col = 0;
+        rect.page = 0;
+        rect.width = OLED_WIDTH;
+        rect.pages = OLED_PAGES;
+        break;
+
+    case OLED_IOC_FLUSH_RECT:
+        if (copy_from_user(&rect, (void __user *)arg, sizeof(rect)))
+            return -EFAULT;
+
+        // 화면 밖 영역 거부
+        if (!oled_rect_valid(&rect))
+            return -EINVAL;
+        break;
+
+    case OLED_IOC_RESET:
+        // 재초기화 후 패널 내용을 모르는 것으로 보고 다음 flush는 전체 전송
+        mutex_lock(&oled_lock);
+        ret = oled_panel_init();
+        oled_shadow_valid = false;
+        mutex_unlock(&oled_lock);
+        return ret;
+
+    case OLED_IOC_DISPLAY_ON:
+    case OLED_IOC_DISPLAY_OFF:
+        return oled_set_display(cmd == OLED_IOC_DISPLAY_ON);
+
+    case OLED_IOC_SET_CONTRAST:
+        if (get_user(contrast, (int __user *)arg))
+            return -EFAULT;
+        if (contrast < 0 || contrast > 255)
+            return -EINVAL;
+
+        cmds[0] = 0x81;
+        cmds[1] = contrast;
+        mutex_lock(&oled_lock);
+        ret = oled_i2c_write_cmds(cmds, 2);
+        if (ret == 0)
+            oled_state.contrast = contrast;
+        mutex_unlock(&oled_lock);
+        return ret;
+
+    case OLED_IOC_GET_STATE:
+        mutex_lock(&oled_lock);
+        state = oled_state;
+        mutex_unlock(&oled_lock);
+
+        if (copy_to_user((void __user *)arg, &state, sizeof(state)))
+            return -EFAULT;
+        return 0;
+
+    default:
+        return -ENOTTY;
+    }
+
+    mutex_lock(&oled_lock);
+    ret = oled_flush(rect.col, rect.page, rect.width, rect.pages);
+    mutex_unlock(&oled_lock);
 
-    kfree(kbuf);
     return ret;
 }
 
@@ -172,8 +609,231 @@ static struct file_operations oled_fops = {
     .open    = oled_open,
     .release = oled_release,
     .write   = oled_write,
+    .fsync   = oled_fsync,
+    .mmap    = oled_mmap,
+    .unlocked_ioctl = oled_ioctl,
 };
 
+/* =========================================================
+ * fbdev (deferred io) 백엔드
+ * - /dev/fbN 으로 일반 렌더러/fbcon/스크린샷 툴이 패널을 쓸 수 있게 함
+ * - fbdev 쪽은 1bpp 선형 버퍼(한 줄 16바이트, 비트 0 = 왼쪽 픽셀)
+ * - 그리기 연산이 건드린 줄(damage)만 모아 두었다가 deferred io 타이머에서
+ *   SSD1306 페이지 형식으로 변환 → oled_fb에 반영 → oled_flush()로 바뀐 부분만 전송
+ * - /dev/my_oled와 같은 oled_fb를 덮어쓰므로 둘 중 하나만 써야 함 (기본은 꺼짐, fbdev=1로 켬)
+ * - sys_fillrect/sys_copyarea/sys_imageblit/fb_sys_read/write를 쓰므로
+ *   해당 CONFIG_FB_SYS_* 가 모두 켜진 커널에서만 빌드 (out-of-tree 모듈이라 select 불가)
+ * ========================================================= */
+#if IS_ENABLED(CONFIG_FB_DEFERRED_IO) && IS_ENABLED(CONFIG_FB_SYS_FOPS) && \
+    IS_ENABLED(CONFIG_FB_SYS_FILLRECT) && IS_ENABLED(CONFIG_FB_SYS_COPYAREA) && \
+    IS_ENABLED(CONFIG_FB_SYS_IMAGEBLIT)
+
+#define OLED_FBDEV_LINE  (OLED_WIDTH / 8)                 // 한 줄 16바이트
+#define OLED_FBDEV_SIZE  (OLED_FBDEV_LINE * OLED_HEIGHT)  // 1024바이트
+
+static bool fbdev = false;
+module_param(fbdev, bool, 0444);
+MODULE_PARM_DESC(fbdev, "Register an fbdev (/dev/fbN); do not use together with /dev/my_oled");
+
+static struct fb_info *oled_fbinfo = NULL;
+static unsigned char *oled_fbdev_mem = NULL;
+
+// 아직 패널에 반영 안 된 줄 범위 [y0, y1) (y0 >= y1이면 없음)
+static DEFINE_SPINLOCK(oled_fbdev_damage_lock);
+static int oled_fbdev_y0 = OLED_HEIGHT;
+static int oled_fbdev_y1 = 0;
+
+// 손상된 줄 범위를 기록하고 deferred io 타이머 예약
+static void oled_fbdev_damage(struct fb_info *info, int y, int h)
+{
+    unsigned long flags;
+
+    spin_lock_irqsave(&oled_fbdev_damage_lock, flags);
+    oled_fbdev_y0 = max(min(oled_fbdev_y0, y), 0);
+    oled_fbdev_y1 = min(max(oled_fbdev_y1, y + h), OLED_HEIGHT);
+    spin_unlock_irqrestore(&oled_fbdev_damage_lock, flags);
+
+    schedule_delayed_work(&info->deferred_work, info->fbdefio->delay);
+}
+
+// deferred io 콜백: 손상된 줄이 속한 페이지만 변환해서 전송
+static void oled_fbdev_deferred_io(struct fb_info *info, struct list_head *pagereflist)
+{
+    unsigned long flags;
+    int y0, y1, p, j, k;
+    unsigned char data;
+    int ret;
+
+    spin_lock_irqsave(&oled_fbdev_damage_lock, flags);
+    y0 = oled_fbdev_y0;
+    y1 = oled_fbdev_y1;
+    oled_fbdev_y0 = OLED_HEIGHT;
+    oled_fbdev_y1 = 0;
+    spin_unlock_irqrestore(&oled_fbdev_damage_lock, flags);
+
+    // mmap으로 쓴 경우(페이지 목록이 있음)는 어느 줄인지 모름 → 화면 전체
+    if (!list_empty(pagereflist)) {
+        y0 = 0;
+        y1 = OLED_HEIGHT;
+    }
+    if (y0 >= y1)
+        return;
+
+    mutex_lock(&oled_lock);
+
+    // 선형 1bpp → SSD1306 페이지 형식 (한 바이트 = 세로 8픽셀, 비트 0 = 맨 위)
+    for (p = y0 / 8; p <= (y1 - 1) / 8; p++) {
+        for (j = 0; j < OLED_WIDTH; j++) {
+            data = 0;
+            for (k = 0; k < 8; k++) {
+                unsigned char byte = oled_fbdev_mem[(p * 8 + k) * OLED_FBDEV_LINE + j / 8];
+                data |= ((byte >> (j % 8)) & 1) << k;
+            }
+            oled_fb[p * OLED_WIDTH + j] = data;
+        }
+    }
+
+    ret = oled_flush(0, y0 / 8, OLED_WIDTH, (y1 - 1) / 8 - y0 / 8 + 1);
+    mutex_unlock(&oled_lock);
+
+    // 전송 실패: 이번 줄 범위를 다시 손상 영역에 합쳐서 다음 deferred io 때 재전송
+    if (ret < 0) {
+        pr_err_ratelimited("OLED: fbdev flush of rows %d-%d failed (%d), retrying\n",
+                           y0, y1 - 1, ret);
+        oled_fbdev_damage(info, y0, y1 - y0);
+    }
+}
+
+static ssize_t oled_fbdev_write(struct fb_info *info, const char __user *buf,
+                                size_t count, loff_t *ppos)
+{
+    loff_t pos = *ppos;
+    ssize_t ret;
+
+    ret = fb_sys_write(info, buf, count, ppos);
+    if (ret > 0)
+        oled_fbdev_damage(info, pos / OLED_FBDEV_LINE,
+                          (pos + ret - 1) / OLED_FBDEV_LINE - pos / OLED_FBDEV_LINE + 1);
+    return ret;
+}
+
+static void oled_fbdev_fillrect(struct fb_info *info, const struct fb_fillrect *rect)
+{
+    sys_fillrect(info, rect);
+    oled_fbdev_damage(info, rect->dy, rect->height);
+}
+
+static void oled_fbdev_copyarea(struct fb_info *info, const struct fb_copyarea *area)
+{
+    sys_copyarea(info, area);
+    oled_fbdev_damage(info, area->dy, area->height);
+}
+
+static void oled_fbdev_imageblit(struct fb_info *info, const struct fb_image *image)
+{
+    sys_imageblit(info, image);
+    oled_fbdev_damage(info, image->dy, image->height);
+}
+
+static int oled_fbdev_blank(int blank_mode, struct fb_info *info)
+{
+    return oled_set_display(blank_mode == FB_BLANK_UNBLANK);
+}
+
+static struct fb_ops oled_fbdev_ops = {
+    .owner        = THIS_MODULE,
+    .fb_read      = fb_sys_read,
+    .fb_write     = oled_fbdev_write,
+    .fb_blank     = oled_fbdev_blank,
+    .fb_fillrect  = oled_fbdev_fillrect,
+    .fb_copyarea  = oled_fbdev_copyarea,
+    .fb_imageblit = oled_fbdev_imageblit,
+    .fb_mmap      = fb_deferred_io_mmap,
+};
+
+static struct fb_deferred_io oled_fbdev_defio = {
+    .delay       = HZ / 20,  // 50ms 동안 모아서 한 번에 전송
+    .deferred_io = oled_fbdev_deferred_io,
+};
+
+static int oled_fbdev_register(void)
+{
+    struct fb_info *info;
+    int ret;
+
+    if (!fbdev)
+        return 0;
+
+    oled_fbdev_mem = (unsigned char *)get_zeroed_page(GFP_KERNEL);
+    if (!oled_fbdev_mem)
+        return -ENOMEM;
+
+    info = framebuffer_alloc(0, &oled_i2c_client->dev);
+    if (!info) {
+        free_page((unsigned long)oled_fbdev_mem);
+        return -ENOMEM;
+    }
+
+    strscpy(info->fix.id, DRIVER_NAME, sizeof(info->fix.id));
+    info->fix.type        = FB_TYPE_PACKED_PIXELS;
+    info->fix.visual      = FB_VISUAL_MONO10;
+    info->fix.accel       = FB_ACCEL_NONE;
+    info->fix.line_length = OLED_FBDEV_LINE;
+    info->fix.smem_start  = __pa(oled_fbdev_mem);
+    info->fix.smem_len    = OLED_FBDEV_SIZE;
+
+    info->var.xres           = OLED_WIDTH;
+    info->var.yres           = OLED_HEIGHT;
+    info->var.xres_virtual   = OLED_WIDTH;
+    info->var.yres_virtual   = OLED_HEIGHT;
+    info->var.bits_per_pixel = 1;
+    info->var.red.length     = 1;
+    info->var.green.length   = 1;
+    info->var.blue.length    = 1;
+
+    info->fbops         = &oled_fbdev_ops;
+    info->fbdefio       = &oled_fbdev_defio;
+    info->screen_buffer = oled_fbdev_mem;
+
+    ret = fb_deferred_io_init(info);
+    if (ret < 0) {
+        framebuffer_release(info);
+        free_page((unsigned long)oled_fbdev_mem);
+        return ret;
+    }
+
+    ret = register_framebuffer(info);
+    if (ret < 0) {
+        fb_deferred_io_cleanup(info);
+        framebuffer_release(info);
+        free_page((unsigned long)oled_fbdev_mem);
+        return ret;
+    }
+
+    oled_fbinfo = info;
+    pr_info("OLED Driver: /dev/fb%d ready\n", info->node);
+    return 0;
+}
+
+static void oled_fbdev_unregister(void)
+{
+    if (!oled_fbinfo)
+        return;
+
+    unregister_framebuffer(oled_fbinfo);
+    fb_deferred_io_cleanup(oled_fbinfo);
+    framebuffer_release(oled_fbinfo);
+    free_page((unsigned long)oled_fbdev_mem);
+    oled_fbinfo = NULL;
+}
+
+#else
+
+static int oled_fbdev_register(void) { return 0; }
+static void oled_fbdev_unregister(void) { }
+
+#endif /* CONFIG_FB_DEFERRED_IO && CONFIG_FB_SYS_* */
+
 /*
  * 모듈 로드 시 실행
  */
@@ -188,15 +848,33 @@ static int __init oled_driver_init(void)
 
     pr_info("OLED Driver: Initializing\n");
 
+    // 프레임버퍼 할당 (1페이지, 앞 1024B 사용)
+    oled_fb = (unsigned char *)get_zeroed_page(GFP_KERNEL);
+    if (!oled_fb)
+        return -ENOMEM;
+
+    // 비동기 전송 워커 (프레임 순서 보장을 위해 ordered)
+    oled_wq = alloc_ordered_workqueue(DRIVER_NAME, 0);
+    if (!oled_wq) {
+        free_page((unsigned long)oled_fb);
+        return -ENOMEM;
+    }
+    INIT_WORK(&oled_flush_work, oled_flush_work_func);
+
     // 문자 디바이스 등록
     ret = register_chrdev(DRIVER_MAJOR, DRIVER_NAME, &oled_fops);
-    if (ret < 0)
+    if (ret < 0) {
+        destroy_workqueue(oled_wq);
+        free_page((unsigned long)oled_fb);
         return ret;
+    }
 
     // I2C 버스 어댑터 얻기
     oled_i2c_adapter = i2c_get_adapter(I2C_BUS_NUM);
     if (!oled_i2c_adapter) {
         unregister_chrdev(DRIVER_MAJOR, DRIVER_NAME);
+        destroy_workqueue(oled_wq);
+        free_page((unsigned long)oled_fb);
         return -ENODEV;
     }
 
@@ -205,9 +883,28 @@ static int __init oled_driver_init(void)
     if (!oled_i2c_client) {
         i2c_put_adapter(oled_i2c_adapter);
         unregister_chrdev(DRIVER_MAJOR, DRIVER_NAME);
+        destroy_workqueue(oled_wq);
+        free_page((unsigned long)oled_fb);
         return -ENODEV;
     }
 
+    // 패널 초기화는 여기서 한 번만 (실패해도 첫 flush 때 다시 시도)
+    mutex_lock(&oled_lock);
+    if (oled_panel_init() < 0)
+        pr_warn("OLED: initial panel init failed, will retry on first flush\n");
+    mutex_unlock(&oled_lock);
+
+    // debugfs 통계 (/sys/kernel/debug/my_oled/)
+    oled_debugfs_dir = debugfs_create_dir(DRIVER_NAME, NULL);
+    debugfs_create_file("stats", 0444, oled_debugfs_dir, NULL, &oled_stats_fops);
+    debugfs_create_u64("last_init_ns", 0444, oled_debugfs_dir, &oled_init_ns);
+    debugfs_create_u64("last_flush_ns", 0444, oled_debugfs_dir, &oled_flush_ns);
+
+    // fbdev 백엔드 (실패해도 /dev/my_oled는 계속 동작)
+    ret = oled_fbdev_register();
+    if (ret < 0)
+        pr_warn("OLED Driver: fbdev registration failed (%d)\n", ret);
+
     pr_info("OLED Driver: /dev/%s ready\n", DRIVER_NAME);
     return 0;
 }
@@ -217,6 +914,13 @@ static int __init oled_driver_init(void)
  */
 static void __exit oled_driver_exit(void)
 {
+    debugfs_remove_recursive(oled_debugfs_dir);
+
+    oled_fbdev_unregister();
+
+    // 대기 중인 프레임 전송을 마치고 워커 정리
+    destroy_workqueue(oled_wq);
+
     if (oled_i2c_client)
         i2c_unregister_device(oled_i2c_client);
 
@@ -224,6 +928,7 @@ static void __exit oled_driver_exit(void)
         i2c_put_adapter(oled_i2c_adapter);
 
     unregister_chrdev(DRIVER_MAJOR, DRIVER_NAME);
+    free_page((unsigned long)oled_fb);
     pr_info("OLED Driver: Exited\n");
 }
 
@@ -0,0 +1,181 @@
+// oled_ssd1306.h
+// SSD1306 화면 구성/ioctl 인터페이스와 I2C 인코딩 헬퍼 (oled_driver.c와 hw_sim.c가 같이 사용)
+// 버스 전송/락은 하지 않고 바이트 배열만 만든다
+// 포함하기 전에 _IO/_IOW/_IOR, memcpy 정의 필요 (커널: <linux/fs.h> / 유저: <sys/ioctl.h>, <string.h>)
+
+#ifndef _OLED_SSD1306_H
+#define _OLED_SSD1306_H
+
+// SSD1306 128x64: 8 페이지 x 128 컬럼 = 1024바이트
+#define OLED_WIDTH    128
+#define OLED_HEIGHT   64
+#define OLED_PAGES    8
+#define OLED_FB_SIZE  (OLED_WIDTH * OLED_PAGES)
+
+/*
+ * 화면 갱신 영역 (ioctl 인자, 유저앱과 그대로 주고받음)
+ * 컬럼은 픽셀 단위, 세로는 페이지(8픽셀) 단위
+ */
+typedef struct {
+    int col;     // 시작 컬럼 (0~127)
+    int page;    // 시작 페이지 (0~7)
+    int width;   // 컬럼 수
+    int pages;   // 페이지 수
+} oled_rect_t;
+
+// 패널 상태 (OLED_IOC_GET_STATE로 조회)
+typedef struct {
+    int initialized;  // 초기화 명령 전송 완료 여부 (I2C 에러 시 0)
+    int display_on;   // 1: Display ON / 0: OFF
+    int contrast;     // 0~255
+} oled_state_t;
+
+// ioctl 명령
+#define OLED_IOC_MAGIC        'O'
+#define OLED_IOC_FLUSH        _IO(OLED_IOC_MAGIC, 1)                 // 화면 전체 flush
+#define OLED_IOC_FLUSH_RECT   _IOW(OLED_IOC_MAGIC, 2, oled_rect_t)   // 지정 영역만 flush
+#define OLED_IOC_RESET        _IO(OLED_IOC_MAGIC, 3)                 // 패널 재초기화
+#define OLED_IOC_DISPLAY_ON   _IO(OLED_IOC_MAGIC, 4)
+#define OLED_IOC_DISPLAY_OFF  _IO(OLED_IOC_MAGIC, 5)
+#define OLED_IOC_SET_CONTRAST _IOW(OLED_IOC_MAGIC, 6, int)
+#define OLED_IOC_GET_STATE    _IOR(OLED_IOC_MAGIC, 7, oled_state_t)
+
+/*
+ * SSD1306 초기화 명령어 테이블
+ * 모듈 로드(또는 재초기화) 시 0x00 컨트롤 바이트 하나 뒤에 붙여서 한 번의 I2C 메시지로 전송됨
+ */
+static const unsigned char oled_init_cmds[] = {
+    0xAE,       // Display OFF
+    0x00,       // Set lower column start address
+    0x10,       // Set higher column start address
+    0x40,       // Set display start line
+    0x81, 0xCF, // Set contrast
+    0xA1,       // Segment remap (좌우 반전)
+    0xC8,       // COM scan direction (상하 반전)
+    0xA6,       // Normal display (반전 아님)
+    0xA8, 0x3F, // Multiplex ratio (1/64)
+    0xD3, 0x00, // Display offset
+    0xD5, 0x80, // Display clock divide ratio
+    0xD9, 0xF1, // Pre-charge period
+    0xDA, 0x12, // COM pins hardware configuration
+    0xDB, 0x40, // VCOMH deselect level
+    0x20, 0x00, // Memory addressing mode = Horizontal
+    0x8D, 0x14, // Charge pump enable
+    0xAF        // Display ON
+};
+
+// ioctl 영역 검사: 화면 밖/빈 영역 거부 (합이 넘치지 않게 남은 폭과 비교)
+static inline int oled_rect_valid(const oled_rect_t *r)
+{
+    return r->col >= 0 && r->page >= 0 && r->width > 0 && r->pages > 0 &&
+           r->width <= OLED_WIDTH - r->col && r->pages <= OLED_PAGES - r->page;
+}
+
+// 창 설정 명령 메시지 7바이트: 0x00 + 0x21 c0 c1 + 0x22 p0 p1
+static inline void oled_set_window(unsigned char win[7], int col_start, int col_end,
+                                   int page_start, int page_end)
+{
+    win[0] = 0x00;          // Command
+    win[1] = 0x21;          // 컬럼 주소 설정
+    win[2] = col_start;
+    win[3] = col_end;
+    win[4] = 0x22;          // 페이지 주소 설정
+    win[5] = page_start;
+    win[6] = page_end;
+}
+
+/*
+ * 한 페이지(128바이트 줄)의 [col, col + width) 에서 fb와 섀도가 다른 첫/마지막 컬럼을 찾음
+ * 바뀐 곳이 없으면 0, 있으면 첫 컬럼을 *first에 넣고 구간 길이(last - first + 1)를 리턴
+ */
+static inline int oled_diff_span(const unsigned char *fb_row, const unsigned char *shadow_row,
+                                 int col, int width, int *first)
+{
+    int c, lo = -1, hi = -1;
+
+    for (c = col; c < col + width; c++) {
+        if (fb_row[c] != shadow_row[c]) {
+            if (lo < 0)
+                lo = c;
+            hi = c;
+        }
+    }
+
+    if (lo < 0)
+        return 0;
+    *first = lo;
+    return hi - lo + 1;
+}
+
+/*
+ * 영역 flush 인코딩 (oled_driver.c의 oled_flush()와 hw_sim.c가 같이 사용)
+ * 전송 순서: 구간마다 [창 설정 7바이트][0x40 + 픽셀 len바이트] 메시지 쌍
+ * 호출하는 쪽은 win[page[i]], span[page[i]]를 보내고, 전송이 끝나면 oled_commit_spans()로 섀도에 반영
+ */
+typedef struct {
+    int n;                      // 보낼 구간 수 (0이면 바뀐 곳 없음)
+    int page[OLED_PAGES];       // 구간 i의 페이지
+    int first[OLED_PAGES];      // 구간 i의 첫 컬럼
+    int len[OLED_PAGES];        // 구간 i의 컬럼 수
+    int sent, skipped;          // 보낼/생략한 픽셀 바이트
+} oled_spans_t;
+
+// 패널 내용을 모를 때: fb를 섀도에 먼저 떠 두고 화면 전체 창 설정 (데이터는 0x40 + 섀도 그대로)
+static inline void oled_encode_full(const unsigned char *fb, unsigned char *shadow,
+                                    unsigned char win[7])
+{
+    memcpy(shadow, fb, OLED_FB_SIZE);
+    oled_set_window(win, 0, OLED_WIDTH - 1, 0, OLED_PAGES - 1);
+}
+
+/*
+ * 영역 안의 페이지마다 섀도와 다른 컬럼 구간을 찾아 창 설정/데이터 버퍼를 채움
+ * 데이터는 지금 fb 값을 떠서 넣으므로 전송 도중 fb가 바뀌어도 커밋 후 섀도 = 패널
+ */
+static inline int oled_encode_spans(const unsigned char *fb, const unsigned char *shadow,
+                                    int col, int page, int width, int pages,
+                                    unsigned char win[OLED_PAGES][7],
+                                    unsigned char span[OLED_PAGES][OLED_WIDTH + 1],
+                                    oled_spans_t *s)
+{
+    int p, first, n, base;
+
+    s->n = s->sent = s->skipped = 0;
+    for (p = page; p < page + pages; p++) {
+        base = p * OLED_WIDTH;
+
+        // 바뀐 곳이 없으면 이 페이지는 건너뜀
+        n = oled_diff_span(fb + base, shadow + base, col, width, &first);
+        if (!n) {
+            s->skipped += width;
+            continue;
+        }
+
+        oled_set_window(win[p], first, first + n - 1, p, p);
+        span[p][0] = 0x40;
+        memcpy(span[p] + 1, fb + base + first, n);
+        s->page[s->n] = p;
+        s->first[s->n] = first;
+        s->len[s->n] = n;
+        s->n++;
+
+        s->sent += n;
+        s->skipped += width - n;
+    }
+    return s->n;
+}
+
+// 전송이 끝난 구간만 섀도에 반영
+static inline void oled_commit_spans(unsigned char *shadow,
+                                     unsigned char span[OLED_PAGES][OLED_WIDTH + 1],
+                                     const oled_spans_t *s)
+{
+    int i, p;
+
+    for (i = 0; i < s->n; i++) {
+        p = s->page[i];
+        memcpy(shadow + p * OLED_WIDTH + s->first[i], span[p] + 1, s->len[i]);
+    }
+}
+
+#endif /* _OLED_SSD1306_H */
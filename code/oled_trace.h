@@ -0,0 +1,97 @@
+// oled_trace.h
+// my_oled 드라이버 tracepoint (/sys/kernel/tracing/events/my_oled/)
+// 꺼져 있을 때는 static key 분기 하나 비용. trace-cmd record -e my_oled 등으로 사용
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM my_oled
+
+#if !defined(_OLED_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _OLED_TRACE_H
+
+#include <linux/tracepoint.h>
+
+// write() 진입: 요청 바이트 수, O_NONBLOCK 여부
+TRACE_EVENT(oled_write_start,
+    TP_PROTO(size_t count, int nonblock),
+    TP_ARGS(count, nonblock),
+    TP_STRUCT__entry(
+        __field(size_t, count)
+        __field(int, nonblock)
+    ),
+    TP_fast_assign(
+        __entry->count = count;
+        __entry->nonblock = nonblock;
+    ),
+    TP_printk("count=%zu nonblock=%d", __entry->count, __entry->nonblock)
+);
+
+// write() 리턴: 처리한 바이트 수 또는 에러
+TRACE_EVENT(oled_write_end,
+    TP_PROTO(size_t count, long ret),
+    TP_ARGS(count, ret),
+    TP_STRUCT__entry(
+        __field(size_t, count)
+        __field(long, ret)
+    ),
+    TP_fast_assign(
+        __entry->count = count;
+        __entry->ret = ret;
+    ),
+    TP_printk("count=%zu ret=%ld", __entry->count, __entry->ret)
+);
+
+// 프레임 전송 한 번: 요청 영역, 실제 전송/생략한 픽셀 바이트, i2c 메시지 수, 소요 시간
+TRACE_EVENT(oled_flush,
+    TP_PROTO(int col, int page, int width, int pages, int sent, int skipped, int msgs, u64 ns),
+    TP_ARGS(col, page, width, pages, sent, skipped, msgs, ns),
+    TP_STRUCT__entry(
+        __field(int, col)
+        __field(int, page)
+        __field(int, width)
+        __field(int, pages)
+        __field(int, sent)
+        __field(int, skipped)
+        __field(int, msgs)
+        __field(u64, ns)
+    ),
+    TP_fast_assign(
+        __entry->col = col;
+        __entry->page = page;
+        __entry->width = width;
+        __entry->pages = pages;
+        __entry->sent = sent;
+        __entry->skipped = skipped;
+        __entry->msgs = msgs;
+        __entry->ns = ns;
+    ),
+    TP_printk("rect=%d,%d %dx%d sent=%d skipped=%d msgs=%d ns=%llu",
+              __entry->col, __entry->page, __entry->width, __entry->pages,
+              __entry->sent, __entry->skipped, __entry->msgs,
+              (unsigned long long)__entry->ns)
+);
+
+// I2C 전송 실패: 메시지 수, 전체 바이트 수, i2c_master_send/i2c_transfer 리턴값
+TRACE_EVENT(oled_i2c_error,
+    TP_PROTO(int msgs, int bytes, int ret),
+    TP_ARGS(msgs, bytes, ret),
+    TP_STRUCT__entry(
+        __field(int, msgs)
+        __field(int, bytes)
+        __field(int, ret)
+    ),
+    TP_fast_assign(
+        __entry->msgs = msgs;
+        __entry->bytes = bytes;
+        __entry->ret = ret;
+    ),
+    TP_printk("msgs=%d bytes=%d ret=%d", __entry->msgs, __entry->bytes, __entry->ret)
+);
+
+#endif /* _OLED_TRACE_H */
+
+// 이 헤더는 드라이버 소스와 같은 디렉터리에 있음 (Makefile: CFLAGS_oled_driver.o := -I$(src))
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE oled_trace
+#include <trace/define_trace.h>
@@ -0,0 +1,77 @@
+// rotary_decode.h
+// 로터리 엔코더 쿼드러처 디코더 (rtc_control_driver.c와 hw_sim.c의 에지 재생 검사가 같이 사용)
+// 핀 읽기/락/통계는 하지 않고 (CLK << 1 | DT) 상태와 에지 시각만 받는다
+
+#ifndef _ROTARY_DECODE_H
+#define _ROTARY_DECODE_H
+
+// 디텐트(딸깍) 위치는 CLK/DT 둘 다 HIGH (풀업)
+#define ROT_REST_STATE      0x3
+// 한 디텐트 = Gray 코드 전이 4번. 튐/누락으로 2~3번만 보여도 방향이 맞으면 1칸으로 인정
+#define ROT_MIN_TRANSITIONS 2
+// 속도 가속: 디텐트 간격이 짧을수록 한 칸에 더 많이 이동
+#define ROT_ACCEL_FAST_MS   30   // 이보다 빠르면 x10
+#define ROT_ACCEL_MED_MS    80   // 이보다 빠르면 x5
+
+/*
+ * Gray 코드 전이표: [이전 상태 << 2 | 현재 상태] → -1 / 0 / +1
+ * 0은 변화 없음 또는 두 비트가 동시에 바뀐 무효 전이 (튐)
+ * 부호는 기존 동작(CLK 하강 때 DT == 0이면 +1)과 같게 맞춤
+ */
+static const signed char rot_table[16] = {
+     0,  1, -1,  0,
+    -1,  0,  0,  1,
+     1,  0,  0, -1,
+     0, -1,  1,  0,
+};
+
+// 디코더 상태: prev = 직전 (CLK << 1 | DT), sub = 디텐트 사이 누적 전이 수
+struct rot_decoder {
+    int prev;
+    int sub;
+    long long last_detent_ms;   // 직전 디텐트 시각 (가속 판정용)
+};
+
+/*
+ * 쿼드러처 디코더 한 단계
+ * state: 현재 (CLK << 1 | DT), now_ms: 에지 시각
+ * 디텐트 위치에 도착하면 가속이 적용된 이동량(부호 = 방향), 아니면 0 리턴
+ * 디텐트에 도착했지만 방향을 정할 수 없어 버렸으면 *rejected = 1
+ */
+static inline int rot_decode_step(struct rot_decoder *d, int state, long long now_ms,
+                                  int *rejected)
+{
+    int dir = 0;
+    long long gap_ms;
+
+    *rejected = 0;
+    d->sub += rot_table[(d->prev << 2) | state];
+    d->prev = state;
+
+    // 디텐트 위치에서만 판정 (중간 위치의 튐은 여기서 상쇄됨)
+    if (state != ROT_REST_STATE)
+        return 0;
+
+    if (d->sub >= ROT_MIN_TRANSITIONS)
+        dir = 1;
+    else if (d->sub <= -ROT_MIN_TRANSITIONS)
+        dir = -1;
+    d->sub = 0;
+
+    if (dir == 0) {
+        *rejected = 1;
+        return 0;
+    }
+
+    // 직전 디텐트와의 간격으로 가속 배율 결정
+    gap_ms = now_ms - d->last_detent_ms;
+    d->last_detent_ms = now_ms;
+
+    if (gap_ms < ROT_ACCEL_FAST_MS)
+        return dir * 10;
+    if (gap_ms < ROT_ACCEL_MED_MS)
+        return dir * 5;
+    return dir;
+}
+
+#endif /* _ROTARY_DECODE_H */
@@ -7,13 +7,30 @@
 #include <linux/gpio.h>       // GPIO 요청, 설정, 값 읽기/쓰기
 #include <linux/interrupt.h> // 인터럽트 등록/해제
 #include <linux/delay.h>     // udelay (마이크로초 지연)
-#include <linux/workqueue.h> // work_struct, schedule_work
-#include <linux/timer.h>     // kernel timer
+#include <linux/workqueue.h> // work_struct, 전용 workqueue
+#include <linux/hrtimer.h>   // 초 경계에 맞춘 고해상도 타이머
+#include <linux/ktime.h>
+#include <linux/moduleparam.h>
+#include <linux/rtc.h>       // RTC 클래스 디바이스 (/dev/rtcN)
+#include <linux/platform_device.h>
+#include <linux/input.h>     // 엔코더/버튼 evdev 이벤트 (REL_DIAL, KEY_ENTER)
 #include <linux/fs.h>        // register_chrdev, file_operations
 #include <linux/uaccess.h>   // copy_to_user, copy_from_user
+#include <linux/wait.h>      // wait queue (상태 변경 대기)
+#include <linux/poll.h>      // poll/select 지원
+#include <linux/seqlock.h>   // current_state 일관된 스냅샷
+#include <linux/mutex.h>     // DS1302 버스 직렬화
+#include <linux/debugfs.h>   // 동작 통계, 지연 히스토그램 노출
+#include <linux/percpu.h>    // 통계 카운터 (CPU별, 락 없음)
+#include <linux/seq_file.h>
+#include <linux/log2.h>
+
+#define CREATE_TRACE_POINTS
+#include "smart_clock_trace.h" // smart_clock:* tracepoint (DS1302 버스, 엔코더/버튼, tick)
 
 #define DEVICE_NAME "smart_clock" // /dev/smart_clock
 #define DEVICE_MAJOR 230          // 문자 디바이스 메이저 번호
+#define RTC_DRV_NAME "smart_clock_rtc" // RTC 클래스 디바이스용 platform device 이름
 
 // ===== GPIO 핀 정의 =====
 // DS1302 RTC 핀
@@ -21,11 +38,17 @@
 #define GPIO_RTC_CLK 20   // DS1302 SCLK
 #define GPIO_RTC_DAT 21   // DS1302 I/O (Data)
 
+#include "ds1302_bitbang.h"  // 비트뱅잉/BCD 변환 (hw_sim.c와 공용, 위 핀 정의 필요)
+
 // 로터리 엔코더 핀
 #define GPIO_ROT_CLK 5    // A상 (CLK)
 #define GPIO_ROT_DT  6    // B상 (DT)
 #define GPIO_ROT_SW  13   // 버튼 (SW)
 
+// ===== 로터리 엔코더 디코더 =====
+// 전이표/디텐트 판정/가속 규칙은 rotary_decode.h (hw_sim.c 에지 재생 검사와 공용)
+#include "rotary_decode.h"
+
 // 시간 정보 구조체 (유저앱과 그대로 주고받음)
 typedef struct {
     int hours;    // 시
@@ -34,198 +57,550 @@ typedef struct {
     int mode;     // 0: 정상 / 1: 시 설정 / 2: 분 설정
 } clock_info_t;
 
-// 현재 시계 상태 (커널 내부 상태)
+/*
+ * 현재 시계 상태 (커널 내부 상태)
+ * 타이머(softirq), workqueue, write()가 동시에 바꾸므로 seqlock으로 보호.
+ * 읽는 쪽은 clock_get_state()로 시/분/초가 섞이지 않은 스냅샷을 얻고, 쓰는 쪽을 막지 않음.
+ * 프로세스 컨텍스트의 쓰기는 같은 CPU의 타이머와 엇갈리지 않게 _bh 버전 사용
+ */
 static clock_info_t current_state;
+static DEFINE_SEQLOCK(state_lock);
+
+/*
+ * DS1302 버스(비트뱅잉 GPIO)와 rtc_now 보호
+ * RTC를 읽고/쓰는 모든 경로는 이 mutex 하나로 직렬화됨 (sleep 가능한 컨텍스트에서만)
+ * 락 순서: rtc_bus_lock → state_lock. RTC 값을 상태에 반영하는 동안에도 놓지 않음
+ */
+static DEFINE_MUTEX(rtc_bus_lock);
+
+// 마지막으로 RTC에서 읽은 날짜 (시간을 쓸 때 날짜는 그대로 유지하기 위해 보관)
+static ds1302_time_t rtc_now = { .date = 1, .month = 1, .day = 1 };
+
+/*
+ * 설정 모드 write-back (rtc_bus_lock으로 보호)
+ * 엔코더로 바꾼 값은 rtc_now에만 반영하고 rtc_dirty 표시.
+ * 모드 0으로 돌아올 때 또는 마지막 조작 후 writeback_idle_ms가 지나면 burst 쓰기 1회로 내보냄.
+ * rtc_dirty인 동안 rtc_now가 DS1302보다 최신이므로 RTC 읽기로 덮어쓰면 안 됨
+ */
+static bool rtc_dirty;
+
+static unsigned int writeback_idle_ms = 3000;
+module_param(writeback_idle_ms, uint, 0644);
+MODULE_PARM_DESC(writeback_idle_ms, "Idle time before pending setting-mode edits are written to the DS1302");
+
+static struct delayed_work writeback_work;
+
+/*
+ * debugfs 통계 (/sys/kernel/debug/smart_clock/stats)
+ * 하드 IRQ에서도 세므로 CPU별 카운터 사용 (this_cpu_inc 한 번, 읽을 때만 합산)
+ */
+static struct dentry *clock_debugfs_dir;
+
+enum {
+    CLK_STAT_ENC_EDGES,         // 엔코더 IRQ (CLK/DT 에지)
+    CLK_STAT_ENC_DETENTS,       // 디텐트 이동으로 인정된 것
+    CLK_STAT_ENC_REJECTED,      // 디텐트 위치에 왔지만 유효 전이가 모자라 버린 것 (바운스)
+    CLK_STAT_BTN_PRESSES,       // 디바운스를 통과한 버튼 눌림
+    CLK_STAT_BTN_DEBOUNCED,     // 200ms 안에 다시 들어와 버린 버튼 에지
+    CLK_STAT_DS1302_READS,      // 시간 burst 읽기
+    CLK_STAT_DS1302_WRITES,     // 시간 burst 쓰기
+    CLK_STAT_DS1302_WRITES_SAVED, // 모아 쓰기로 생략한 쓰기
+    CLK_STAT_NR
+};
+
+static const char * const clock_stat_names[CLK_STAT_NR] = {
+    "encoder_edges", "encoder_detents", "encoder_rejected",
+    "button_presses", "button_debounced",
+    "ds1302_reads", "ds1302_writes", "ds1302_writes_saved",
+};
+
+struct clock_stats {
+    u64 cnt[CLK_STAT_NR];
+};
+
+static DEFINE_PER_CPU(struct clock_stats, clock_stats);
+
+#define clock_stat_inc(i) this_cpu_inc(clock_stats.cnt[i])
 
 // 인터럽트 번호 저장용
 static int irq_rotary_clk;
+static int irq_rotary_dt;
 static int irq_rotary_sw;
 
 // 디바운싱용 마지막 인터럽트 시간
-static unsigned long last_rotary_time = 0;
 static unsigned long last_btn_time = 0;
 
+/*
+ * 쿼드러처 디코더 상태 (두 핀의 IRQ가 서로 다른 CPU에서 돌 수 있어 spinlock으로 보호)
+ * rot_dec: 직전 핀 상태, 디텐트 사이 누적 전이 수, 직전 디텐트 시각
+ * rot_delta: work가 아직 반영하지 않은 누적 이동량 (가속 포함, 부호 = 방향)
+ */
+static DEFINE_SPINLOCK(rot_lock);
+static struct rot_decoder rot_dec = { .prev = ROT_REST_STATE };
+static atomic_t rot_delta = ATOMIC_INIT(0);
+
 // workqueue 구조체 (인터럽트에서 실제 처리 미루기)
 static struct work_struct rotary_work;
 static struct work_struct btn_work;
 
-// 1초 주기 타이머
-static struct timer_list my_timer;
+/*
+ * 이 드라이버 전용 workqueue (WQ_HIGHPRI)
+ * 시스템 공용 events 큐에 넣으면 다른 커널 작업 뒤에 밀려 엔코더 반응이 늦어짐.
+ * wq_unbound=1이면 IRQ를 받은 CPU에 묶지 않고 한가한 CPU에서 실행
+ */
+static struct workqueue_struct *clock_wq;
+
+static bool wq_unbound;
+module_param(wq_unbound, bool, 0444);
+MODULE_PARM_DESC(wq_unbound, "Run encoder/button work on an unbound (not CPU-affine) workqueue");
+
+/*
+ * IRQ → work 완료 지연 히스토그램 (log2, 마이크로초 단위)
+ * bucket[0]: 2us 미만, bucket[i]: 2^i ~ 2^(i+1) us, 마지막 bucket은 그 이상 전부
+ * 각 히스토그램은 자기 work 하나만 갱신 (같은 work는 동시에 두 번 돌지 않음)
+ */
+#define LAT_BUCKETS 20
+
+typedef struct {
+    const char *name;
+    atomic64_t irq_ns;       // 아직 처리되지 않은 가장 오래된 IRQ 시각 (0 = 없음)
+    unsigned long count[LAT_BUCKETS];
+    unsigned long samples;
+    u64 max_ns;
+} lat_hist_t;
+
+static lat_hist_t rot_lat = { .name = "rotary" };
+static lat_hist_t btn_lat = { .name = "button" };
+
+/*
+ * 입력 서브시스템 디바이스 (/dev/input/eventN)
+ * 시계 설정과 무관하게 디텐트마다 REL_DIAL ±1, 버튼마다 KEY_ENTER 눌림/뗌을 IRQ에서 바로 보고.
+ * 등록에 실패하면 NULL (시계 기능은 그대로 동작)
+ */
+static struct input_dev *rot_input;
+
+// 1초 주기 타이머 (CLOCK_MONOTONIC 절대 시각 기준이라 지연이 누적되지 않음)
+// 첫 만료만 벽시계 초 경계에 맞추고, 이후 settimeofday/NTP로 벽시계가 튀어도 영향 없음
+static struct hrtimer tick_timer;
+
+// RTC 재동기화 주기 (초). 버스 I/O는 프로세스 컨텍스트의 delayed work에서만
+static unsigned int resync_interval_sec = 60;
+module_param(resync_interval_sec, uint, 0644);
+MODULE_PARM_DESC(resync_interval_sec, "Seconds between DS1302 resyncs (min 1)");
+
+static struct delayed_work resync_work;
+
+// 상태 변경 알림: current_state가 바뀔 때마다 세대 번호 증가 + 대기 중인 reader 깨움
+// 각 파일은 마지막으로 읽은 세대 번호를 file->private_data에 기억
+static DECLARE_WAIT_QUEUE_HEAD(clock_waitq);
+static atomic_t state_gen = ATOMIC_INIT(1);
+
+// current_state를 바꾼 쪽에서 호출
+static void clock_state_changed(void)
+{
+    atomic_inc(&state_gen);
+    wake_up_interruptible(&clock_waitq);
+}
 
 /* =========================================================
  * DS1302 Low Level Bit-Banging
+ * 핀 순서는 ds1302_bitbang.h, 여기서는 트랜잭션 시간 tracepoint만 더함
  * ========================================================= */
 
-// DS1302로 1바이트 쓰기 (LSB first)
-void ds1302_write_byte(unsigned char dat)
+// DS1302 레지스터 쓰기
+void ds1302_write_reg(unsigned char cmd, unsigned char data)
 {
-    int i;
+    u64 start = ktime_get_ns();
 
-    // DAT 핀을 출력으로 설정
-    gpio_direction_output(GPIO_RTC_DAT, 0);
+    __ds1302_write_reg(cmd, data);
+    trace_ds1302_xfer(cmd, 1, ktime_get_ns() - start);
+}
 
-    // 8비트 전송
-    for (i = 0; i < 8; i++) {
-        // 현재 LSB를 DAT 핀으로 출력
-        gpio_set_value(GPIO_RTC_DAT, dat & 0x01);
-        udelay(2);
+// DS1302 레지스터 읽기
+unsigned char ds1302_read_reg(unsigned char cmd)
+{
+    unsigned char data;
+    u64 start = ktime_get_ns();
 
-        // CLK 상승 에지
-        gpio_set_value(GPIO_RTC_CLK, 1);
-        udelay(2);
+    data = __ds1302_read_reg(cmd);
+    trace_ds1302_xfer(cmd, 1, ktime_get_ns() - start);
+    return data;
+}
 
-        // CLK 하강 에지
-        gpio_set_value(GPIO_RTC_CLK, 0);
-        udelay(2);
+// DS1302 clock burst 읽기 (시간 레지스터 8개 스냅샷)
+void ds1302_burst_read(unsigned char regs[8])
+{
+    u64 start = ktime_get_ns();
 
-        // 다음 비트
-        dat >>= 1;
-    }
+    __ds1302_burst_read(regs);
+    trace_ds1302_xfer(DS1302_CMD_BURST_READ, 8, ktime_get_ns() - start);
 }
 
-// DS1302에서 1바이트 읽기 (LSB first)
-unsigned char ds1302_read_byte(void)
+// DS1302 clock burst 쓰기 (8바이트, 마지막이 Write Protect)
+void ds1302_burst_write(const unsigned char regs[8])
 {
-    int i;
-    unsigned char dat = 0;
+    u64 start = ktime_get_ns();
+
+    __ds1302_burst_write(regs);
+    trace_ds1302_xfer(DS1302_CMD_BURST_WRITE, 8, ktime_get_ns() - start);
+}
 
-    // DAT 핀을 입력으로 설정
-    gpio_direction_input(GPIO_RTC_DAT);
+// RTC에서 날짜/시간 전체 읽기 (burst 1회)
+void ds1302_read_time(ds1302_time_t *t)
+{
+    unsigned char r[8];
 
-    for (i = 0; i < 8; i++) {
-        dat >>= 1;
+    ds1302_burst_read(r);
+    clock_stat_inc(CLK_STAT_DS1302_READS);
+    ds1302_regs_to_time(r, t);
+}
 
-        // DAT 핀 값 읽기
-        if (gpio_get_value(GPIO_RTC_DAT))
-            dat |= 0x80;
+// RTC에 날짜/시간 전체 쓰기 (Write Protect OFF 1회 + burst 1회)
+void ds1302_write_time(const ds1302_time_t *t)
+{
+    unsigned char r[8];
 
-        gpio_set_value(GPIO_RTC_CLK, 1);
-        udelay(2);
-        gpio_set_value(GPIO_RTC_CLK, 0);
-        udelay(2);
-    }
-    return dat;
+    ds1302_time_to_regs(t, r);
+    ds1302_write_reg(DS1302_CMD_WP_WRITE, 0x00); // Write Protect OFF
+    ds1302_burst_write(r);
 }
 
-// DS1302 레지스터 쓰기
-void ds1302_write_reg(unsigned char cmd, unsigned char data)
+// 현재 시계 상태 스냅샷 (락 없이, 쓰는 중이었으면 다시 읽음)
+static void clock_get_state(clock_info_t *out)
 {
-    gpio_set_value(GPIO_RTC_RST, 1);  // 통신 시작
-    ds1302_write_byte(cmd);           // 주소 전송
-    ds1302_write_byte(data);          // 데이터 전송
-    gpio_set_value(GPIO_RTC_RST, 0);  // 통신 종료
-    gpio_set_value(GPIO_RTC_CLK, 0);  // CLK 안정화
+    unsigned int seq;
+
+    do {
+        seq = read_seqbegin(&state_lock);
+        *out = current_state;
+    } while (read_seqretry(&state_lock, seq));
 }
 
-// DS1302 레지스터 읽기
-unsigned char ds1302_read_reg(unsigned char cmd)
+// RTC에서 현재 시간 읽어서 내부 상태에 반영 (설정 모드 중에는 사용자가 바꾸는 값 유지)
+void get_rtc_time(void)
 {
-    unsigned char data;
+    mutex_lock(&rtc_bus_lock);
+    // 아직 내보내지 않은 편집이 있으면 DS1302 값이 오래된 것이므로 읽지 않음
+    if (rtc_dirty) {
+        mutex_unlock(&rtc_bus_lock);
+        return;
+    }
+    ds1302_read_time(&rtc_now);
 
-    gpio_set_value(GPIO_RTC_RST, 1);  // 통신 시작
-    ds1302_write_byte(cmd);           // 읽기 명령
-    data = ds1302_read_byte();        // 데이터 수신
-    gpio_set_value(GPIO_RTC_RST, 0);  // 통신 종료
-    gpio_set_value(GPIO_RTC_CLK, 0);
-    return data;
+    // 버스 락을 쥔 채 반영: 먼저 풀면 그 사이 write()/RTC set이 쓴 새 시간을 덮어씀
+    write_seqlock_bh(&state_lock);
+    if (current_state.mode == 0) {
+        current_state.seconds = rtc_now.seconds;
+        current_state.minutes = rtc_now.minutes;
+        current_state.hours   = rtc_now.hours;
+    }
+    write_sequnlock_bh(&state_lock);
+    mutex_unlock(&rtc_bus_lock);
 }
 
-// BCD → 10진수 변환 매크로
-#define BCD2BIN(val) (((val) & 0x0f) + ((val) >> 4) * 10)
+// rtc_now 전체를 DS1302에 쓰고 보류 중인 편집 정리
+// rtc_bus_lock을 잡은 상태에서 호출
+static void rtc_write_now(void)
+{
+    ds1302_write_time(&rtc_now);
+    rtc_dirty = false;
+    clock_stat_inc(CLK_STAT_DS1302_WRITES);
+}
 
-// 10진수 → BCD 변환 매크로
-#define BIN2BCD(val) ((((val) / 10) << 4) + ((val) % 10))
+// RTC에 시간 쓰기 (날짜는 마지막으로 읽은 값 유지)
+// rtc_bus_lock을 잡은 상태에서 호출
+void set_rtc_time(const clock_info_t *t)
+{
+    rtc_now.hours   = t->hours;
+    rtc_now.minutes = t->minutes;
+    rtc_now.seconds = t->seconds;
 
-// RTC에서 현재 시간 읽기
-void get_rtc_time(void)
+    rtc_write_now();
+}
+
+// 설정 모드 편집: rtc_now만 바꾸고 쓰기는 미룸 (rtc_bus_lock을 잡은 상태에서 호출)
+// 이미 보류 중인 편집이 있으면 그 쓰기 1회를 아낀 것
+static void set_rtc_time_deferred(const clock_info_t *t)
 {
-    current_state.seconds = BCD2BIN(ds1302_read_reg(0x81));
-    current_state.minutes = BCD2BIN(ds1302_read_reg(0x83));
-    current_state.hours   = BCD2BIN(ds1302_read_reg(0x85));
+    rtc_now.hours   = t->hours;
+    rtc_now.minutes = t->minutes;
+    rtc_now.seconds = t->seconds;
+
+    if (rtc_dirty)
+        clock_stat_inc(CLK_STAT_DS1302_WRITES_SAVED);
+    rtc_dirty = true;
+
+    mod_delayed_work(clock_wq, &writeback_work, msecs_to_jiffies(writeback_idle_ms));
 }
 
-// RTC에 현재 시간 쓰기
-void set_rtc_time(void)
+// 보류 중인 편집이 있으면 지금 내보냄 (rtc_bus_lock을 잡은 상태에서 호출)
+static void rtc_flush_pending(void)
 {
-    ds1302_write_reg(0x8E, 0x00); // Write Protect OFF
-    ds1302_write_reg(0x84, BIN2BCD(current_state.hours));
-    ds1302_write_reg(0x82, BIN2BCD(current_state.minutes));
-    ds1302_write_reg(0x80, BIN2BCD(current_state.seconds));
-    ds1302_write_reg(0x8E, 0x80); // Write Protect ON
+    if (rtc_dirty)
+        rtc_write_now();
 }
 
 /* =========================================================
  * Logic Layer
  * ========================================================= */
 
-// 1초마다 실행되는 타이머 콜백
-void timer_callback(struct timer_list *t)
+// 내부 시계를 secs초만큼 진행 (시/분 자리올림 포함)
+static void clock_advance(int secs)
 {
+    int total = current_state.hours * 3600 + current_state.minutes * 60 +
+                current_state.seconds + secs;
+
+    total %= 24 * 3600;
+    current_state.hours   = total / 3600;
+    current_state.minutes = (total / 60) % 60;
+    current_state.seconds = total % 60;
+}
+
+// 매 초 경계마다 실행되는 hrtimer 콜백 (softirq 컨텍스트, 버스 I/O 없음)
+static enum hrtimer_restart timer_callback(struct hrtimer *t)
+{
+    bool ticked = false;
+    u64 overruns;
+
+    // 다음 초 경계로 이동. 1보다 크면 콜백이 늦어 경계를 여러 번 지난 것
+    overruns = hrtimer_forward_now(t, ns_to_ktime(NSEC_PER_SEC));
+
+    write_seqlock(&state_lock);
+
     // 정상 모드일 때만 내부 초 증가
     if (current_state.mode == 0) {
-        current_state.seconds++;
+        clock_advance(1);
+        ticked = true;
+    }
 
-        if (current_state.seconds > 59) {
-            current_state.seconds = 0;
-            current_state.minutes++;
-            get_rtc_time(); // 분 단위로 RTC와 동기화
-        }
+    write_sequnlock(&state_lock);
 
-        if (current_state.minutes > 59) {
-            current_state.minutes = 0;
-            current_state.hours++;
-        }
+    trace_smart_clock_tick(overruns, ticked);
+
+    // 늦은 만큼을 직접 더하지 않고 DS1302에서 다시 읽어 맞춤 (버스 I/O는 work에서)
+    if (overruns > 1)
+        mod_delayed_work(clock_wq, &resync_work, 0);
+
+    if (ticked)
+        clock_state_changed();
+
+    return HRTIMER_RESTART;
+}
+
+// 주기적 RTC 재동기화 (workqueue)
+static void resync_work_func(struct work_struct *work)
+{
+    clock_info_t before, after;
+
+    clock_get_state(&before);
+    get_rtc_time();
+    clock_get_state(&after);
 
-        if (current_state.hours > 23)
-            current_state.hours = 0;
+    if (memcmp(&before, &after, sizeof(clock_info_t)))
+        clock_state_changed();
+
+    queue_delayed_work(clock_wq, &resync_work,
+                          msecs_to_jiffies(max_t(unsigned int, resync_interval_sec, 1) * 1000));
+}
+
+// IRQ 시각 기록: 이미 처리 대기 중인 IRQ가 있으면 그 (더 오래된) 시각 유지
+static void lat_irq_stamp(lat_hist_t *h)
+{
+    atomic64_cmpxchg(&h->irq_ns, 0, ktime_get_ns());
+}
+
+// work 완료 시점에 호출: 대기 중이던 가장 오래된 IRQ부터 지금까지의 지연을 누적
+static void lat_work_done(lat_hist_t *h)
+{
+    s64 irq_ns = atomic64_xchg(&h->irq_ns, 0);
+    u64 ns;
+    unsigned long us;
+    int b = 0;
+
+    if (irq_ns == 0)
+        return;
+
+    ns = ktime_get_ns() - irq_ns;
+    us = (unsigned long)div_u64(ns, NSEC_PER_USEC);
+    if (us >= 2)
+        b = min_t(int, ilog2(us), LAT_BUCKETS - 1);
+
+    h->count[b]++;
+    h->samples++;
+    if (ns > h->max_ns)
+        h->max_ns = ns;
+}
+
+static void lat_hist_show(struct seq_file *m, const lat_hist_t *h)
+{
+    int i;
+
+    seq_printf(m, "%s: samples %lu max_us %llu\n",
+               h->name, h->samples, (unsigned long long)div_u64(h->max_ns, NSEC_PER_USEC));
+    for (i = 0; i < LAT_BUCKETS; i++) {
+        if (!h->count[i])
+            continue;
+        if (i == 0)
+            seq_printf(m, "  %8s %7u us: %lu\n", "<", 2, h->count[i]);
+        else if (i == LAT_BUCKETS - 1)
+            seq_printf(m, "  %8s %7lu us: %lu\n", ">=", 1UL << i, h->count[i]);
+        else
+            seq_printf(m, "  %8lu-%7lu us: %lu\n", 1UL << i, (1UL << (i + 1)) - 1, h->count[i]);
     }
+}
 
-    // 다음 1초 타이머 재설정
-    mod_timer(&my_timer, jiffies + msecs_to_jiffies(1000));
+// /sys/kernel/debug/smart_clock/irq_latency
+static int irq_latency_show(struct seq_file *m, void *v)
+{
+    lat_hist_show(m, &rot_lat);
+    lat_hist_show(m, &btn_lat);
+    return 0;
 }
+DEFINE_SHOW_ATTRIBUTE(irq_latency);
+
+// /sys/kernel/debug/smart_clock/stats: 모든 CPU 카운터 합산
+static int clock_stats_show(struct seq_file *m, void *v)
+{
+    u64 sum[CLK_STAT_NR] = {0};
+    int cpu, i;
+
+    for_each_possible_cpu(cpu) {
+        for (i = 0; i < CLK_STAT_NR; i++)
+            sum[i] += per_cpu_ptr(&clock_stats, cpu)->cnt[i];
+    }
+
+    for (i = 0; i < CLK_STAT_NR; i++)
+        seq_printf(m, "%-20s %llu\n", clock_stat_names[i], (unsigned long long)sum[i]);
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(clock_stats);
 
 // 로터리 엔코더 회전 처리 (workqueue)
-static void rotary_work_func(struct work_struct *work)
+// IRQ에서 모아 둔 이동량을 한 번에 반영
+static void rotary_apply(int delta)
 {
-    int dt_val = gpio_get_value(GPIO_ROT_DT);
+    clock_info_t snap;
 
-    // 회전 방향 판단
-    int change = (dt_val != 1) ? 1 : -1;
+    if (delta == 0)
+        return;
+
+    // 상태 변경 → RTC 쓰기 순서가 다른 writer와 엇갈리지 않도록 버스 락 안에서
+    mutex_lock(&rtc_bus_lock);
+    write_seqlock_bh(&state_lock);
 
     // 시 설정 모드
     if (current_state.mode == 1) {
-        current_state.hours += change;
-        if (current_state.hours > 23) current_state.hours = 0;
-        else if (current_state.hours < 0) current_state.hours = 23;
-        set_rtc_time();
+        current_state.hours = ((current_state.hours + delta) % 24 + 24) % 24;
     }
     // 분 설정 모드
     else if (current_state.mode == 2) {
-        current_state.minutes += change;
-        if (current_state.minutes > 59) current_state.minutes = 0;
-        else if (current_state.minutes < 0) current_state.minutes = 59;
+        current_state.minutes = ((current_state.minutes + delta) % 60 + 60) % 60;
         current_state.seconds = 0;
-        set_rtc_time();
     }
+    else {
+        // 정상 모드에서는 회전 무시 (상태 변화 없음)
+        write_sequnlock_bh(&state_lock);
+        mutex_unlock(&rtc_bus_lock);
+        return;
+    }
+
+    snap = current_state;
+    write_sequnlock_bh(&state_lock);
+
+    trace_smart_clock_apply(snap.mode, delta, snap.hours, snap.minutes, snap.seconds);
+
+    // 디텐트마다 RTC에 쓰지 않고 모아 뒀다가 모드 종료/유휴 시 한 번에
+    set_rtc_time_deferred(&snap);
+    mutex_unlock(&rtc_bus_lock);
+
+    clock_state_changed();
+}
+
+static void rotary_work_func(struct work_struct *work)
+{
+    rotary_apply(atomic_xchg(&rot_delta, 0));
+    lat_work_done(&rot_lat);
+}
+
+// 설정 모드에서 조작이 writeback_idle_ms 동안 없으면 보류 중인 편집 내보내기
+static void writeback_work_func(struct work_struct *work)
+{
+    mutex_lock(&rtc_bus_lock);
+    rtc_flush_pending();
+    mutex_unlock(&rtc_bus_lock);
 }
 
 // 버튼 눌림 처리 (mode 변경)
+// 설정 모드를 빠져나올 때 보류 중인 편집을 burst 쓰기 1회로 반영
 static void btn_work_func(struct work_struct *work)
 {
+    clock_info_t snap;
+    int mode;
+
+    mutex_lock(&rtc_bus_lock);
+
+    write_seqlock_bh(&state_lock);
     current_state.mode++;
     if (current_state.mode > 2)
         current_state.mode = 0;
+    mode = current_state.mode;
+    snap = current_state;
+    write_sequnlock_bh(&state_lock);
+
+    trace_smart_clock_apply(mode, 0, snap.hours, snap.minutes, snap.seconds);
+
+    if (mode == 0) {
+        cancel_delayed_work(&writeback_work);
+        rtc_flush_pending();
+    }
+
+    mutex_unlock(&rtc_bus_lock);
+
+    clock_state_changed();
+    lat_work_done(&btn_lat);
+}
+
+/*
+ * 쿼드러처 디코더 한 단계 (rot_lock을 잡은 상태에서 호출)
+ * state: 현재 (CLK << 1 | DT), now: 에지 시각
+ * 디텐트 위치에 도착하면 가속이 적용된 이동량(부호 = 방향), 아니면 0 리턴
+ */
+static int rot_decode(int state, ktime_t now)
+{
+    int rejected;
+    int step = rot_decode_step(&rot_dec, state, ktime_to_ms(now), &rejected);
+
+    if (rejected)
+        clock_stat_inc(CLK_STAT_ENC_REJECTED);
+    return step;
 }
 
-// 로터리 엔코더 인터럽트 핸들러
+// 로터리 엔코더 인터럽트 핸들러 (CLK, DT 양쪽 에지 공용)
+// 하드 IRQ에서 바로 디코딩하고 이동량만 누적, 실제 반영은 work 하나로 모아서
 static irqreturn_t rotary_irq_handler(int irq, void *dev_id)
 {
-    unsigned long current_time = jiffies;
+    int state = (gpio_get_value(GPIO_ROT_CLK) << 1) | gpio_get_value(GPIO_ROT_DT);
+    int step;
+
+    spin_lock(&rot_lock);
+    step = rot_decode(state, ktime_get());
+    spin_unlock(&rot_lock);
+
+    trace_smart_clock_encoder(state, step);
+    clock_stat_inc(CLK_STAT_ENC_EDGES);
+
+    if (step) {
+        clock_stat_inc(CLK_STAT_ENC_DETENTS);
+
+        // evdev에는 가속 없이 디텐트 1칸 = 1 (가속은 소비자가 결정)
+        if (rot_input) {
+            input_report_rel(rot_input, REL_DIAL, step > 0 ? 1 : -1);
+            input_sync(rot_input);
+        }
 
-    // 디바운싱 (150ms)
-    if (time_after(current_time, last_rotary_time + msecs_to_jiffies(150))) {
-        last_rotary_time = current_time;
-        schedule_work(&rotary_work);
+        lat_irq_stamp(&rot_lat);
+        atomic_add(step, &rot_delta);
+        queue_work(clock_wq, &rotary_work);
     }
     return IRQ_HANDLED;
 }
@@ -234,11 +609,27 @@ static irqreturn_t rotary_irq_handler(int irq, void *dev_id)
 static irqreturn_t button_irq_handler(int irq, void *dev_id)
 {
     unsigned long current_time = jiffies;
+    bool accepted = time_after(current_time, last_btn_time + msecs_to_jiffies(200));
+
+    trace_smart_clock_button(accepted);
 
     // 디바운싱 (200ms)
-    if (time_after(current_time, last_btn_time + msecs_to_jiffies(200))) {
+    if (accepted) {
         last_btn_time = current_time;
-        schedule_work(&btn_work);
+        clock_stat_inc(CLK_STAT_BTN_PRESSES);
+
+        // 하강 에지만 받으므로 눌림/뗌을 한 번에 보고
+        if (rot_input) {
+            input_report_key(rot_input, KEY_ENTER, 1);
+            input_sync(rot_input);
+            input_report_key(rot_input, KEY_ENTER, 0);
+            input_sync(rot_input);
+        }
+
+        lat_irq_stamp(&btn_lat);
+        queue_work(clock_wq, &btn_work);
+    } else {
+        clock_stat_inc(CLK_STAT_BTN_DEBOUNCED);
     }
     return IRQ_HANDLED;
 }
@@ -247,18 +638,55 @@ static irqreturn_t button_irq_handler(int irq, void *dev_id)
  * File Operations
  * ========================================================= */
 
+// open(): 아직 아무 상태도 읽지 않은 것으로 표시 → 첫 read는 바로 리턴
+static int clock_open(struct inode *inode, struct file *file)
+{
+    file->private_data = (void *)0UL;
+    return 0;
+}
+
 // read(): 현재 시간 상태를 유저로 전달
+// 이 파일이 이미 최신 상태를 읽었으면 다음 변경(초 증가, 모드/값 변경)까지 대기
+// (O_NONBLOCK이면 -EAGAIN)
 static ssize_t clock_read(struct file *file,
                           char __user *buf,
                           size_t count,
                           loff_t *f_pos)
 {
-    if (copy_to_user(buf, &current_state, sizeof(clock_info_t)))
+    int seen = (int)(unsigned long)file->private_data;
+    clock_info_t snap;
+    int gen;
+    int ret;
+
+    gen = atomic_read(&state_gen);
+    if (gen == seen) {
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        ret = wait_event_interruptible(clock_waitq, atomic_read(&state_gen) != seen);
+        if (ret)
+            return ret;
+        gen = atomic_read(&state_gen);
+    }
+
+    clock_get_state(&snap);
+    if (copy_to_user(buf, &snap, sizeof(clock_info_t)))
         return -EFAULT;
 
+    file->private_data = (void *)(unsigned long)gen;
     return sizeof(clock_info_t);
 }
 
+// poll(): 이 파일이 아직 읽지 않은 상태 변경이 있으면 읽기 가능
+static __poll_t clock_poll(struct file *file, poll_table *wait)
+{
+    poll_wait(file, &clock_waitq, wait);
+
+    if (atomic_read(&state_gen) != (int)(unsigned long)file->private_data)
+        return EPOLLIN | EPOLLRDNORM;
+    return 0;
+}
+
 // write(): 앱에서 전달된 시간으로 RTC 설정
 static ssize_t clock_write(struct file *file,
                            const char __user *buf,
@@ -270,27 +698,160 @@ static ssize_t clock_write(struct file *file,
     if (copy_from_user(&new_time, buf, sizeof(clock_info_t)))
         return -EFAULT;
 
+    mutex_lock(&rtc_bus_lock);
+
+    write_seqlock_bh(&state_lock);
     current_state.hours   = new_time.hours;
     current_state.minutes = new_time.minutes;
     current_state.seconds = new_time.seconds;
+    write_sequnlock_bh(&state_lock);
 
-    set_rtc_time(); // 하드웨어 RTC에 반영
+    set_rtc_time(&new_time); // 하드웨어 RTC에 반영
+    mutex_unlock(&rtc_bus_lock);
+
+    clock_state_changed();
     return count;
 }
 
 // 파일 오퍼레이션 구조체
 static struct file_operations clock_fops = {
     .owner = THIS_MODULE,
+    .open  = clock_open,
     .read  = clock_read,
     .write = clock_write,
+    .poll  = clock_poll,
 };
 
+/* =========================================================
+ * RTC Class Device (/dev/rtcN)
+ * hwclock, NTP 도구가 RTC_RD_TIME/RTC_SET_TIME으로 DS1302에 접근.
+ * rtc_time 캐싱, UIE 에뮬레이션은 커널 RTC 코어가 처리
+ * ========================================================= */
+
+static struct platform_device *rtc_pdev;
+
+// RTC_RD_TIME: burst 한 번으로 날짜/시간 전체 읽기
+static int ds1302_rtc_read_time(struct device *dev, struct rtc_time *tm)
+{
+    ds1302_time_t t;
+
+    mutex_lock(&rtc_bus_lock);
+    // 설정 모드에서 바꾼 값이 남아 있으면 먼저 반영해서 DS1302와 일치시킨 뒤 읽음
+    rtc_flush_pending();
+    ds1302_read_time(&rtc_now);
+    t = rtc_now;
+    mutex_unlock(&rtc_bus_lock);
+
+    tm->tm_sec  = t.seconds;
+    tm->tm_min  = t.minutes;
+    tm->tm_hour = t.hours;
+    tm->tm_mday = t.date;
+    tm->tm_mon  = t.month - 1;   // rtc_time: 0~11
+    tm->tm_year = t.year + 100;  // rtc_time: 1900년 기준
+    tm->tm_wday = t.day - 1;     // rtc_time: 0~6
+
+    return 0;
+}
+
+// RTC_SET_TIME: burst로 날짜/시간 전체 쓰고 /dev/smart_clock 상태에도 반영
+static int ds1302_rtc_set_time(struct device *dev, struct rtc_time *tm)
+{
+    ds1302_time_t t = {
+        .seconds = tm->tm_sec,
+        .minutes = tm->tm_min,
+        .hours   = tm->tm_hour,
+        .date    = tm->tm_mday,
+        .month   = tm->tm_mon + 1,
+        .day     = tm->tm_wday + 1,
+        .year    = tm->tm_year - 100,
+    };
+
+    mutex_lock(&rtc_bus_lock);
+    // 날짜/시간 전체를 덮어쓰므로 보류 중인 편집은 버림
+    rtc_now = t;
+    rtc_write_now();
+
+    write_seqlock_bh(&state_lock);
+    current_state.hours   = t.hours;
+    current_state.minutes = t.minutes;
+    current_state.seconds = t.seconds;
+    write_sequnlock_bh(&state_lock);
+    mutex_unlock(&rtc_bus_lock);
+
+    clock_state_changed();
+    return 0;
+}
+
+static const struct rtc_class_ops ds1302_rtc_ops = {
+    .read_time = ds1302_rtc_read_time,
+    .set_time  = ds1302_rtc_set_time,
+};
+
+static int ds1302_rtc_probe(struct platform_device *pdev)
+{
+    struct rtc_device *rtc;
+
+    rtc = devm_rtc_allocate_device(&pdev->dev);
+    if (IS_ERR(rtc))
+        return PTR_ERR(rtc);
+
+    rtc->ops = &ds1302_rtc_ops;
+    rtc->range_min = RTC_TIMESTAMP_BEGIN_2000;  // DS1302 연도는 두 자리 (2000~2099)
+    rtc->range_max = RTC_TIMESTAMP_END_2099;
+
+    // 알람 없음 → 업데이트 인터럽트는 RTC 코어의 UIE 에뮬레이션 사용
+    clear_bit(RTC_FEATURE_ALARM, rtc->features);
+
+    return devm_rtc_register_device(rtc);
+}
+
+static struct platform_driver ds1302_rtc_driver = {
+    .probe  = ds1302_rtc_probe,
+    .driver = {
+        .name = RTC_DRV_NAME,
+    },
+};
+
+// 엔코더/버튼 입력 디바이스 등록 (IRQ 등록 전에 호출)
+static void rot_input_register(void)
+{
+    struct input_dev *dev = input_allocate_device();
+
+    if (!dev)
+        goto fail;
+
+    dev->name = "smart_clock rotary encoder";
+    dev->phys = DEVICE_NAME "/input0";
+    dev->id.bustype = BUS_HOST;
+
+    input_set_capability(dev, EV_REL, REL_DIAL);
+    input_set_capability(dev, EV_KEY, KEY_ENTER);
+
+    if (input_register_device(dev)) {
+        input_free_device(dev);
+        goto fail;
+    }
+
+    rot_input = dev;
+    return;
+
+fail:
+    pr_warn("smart_clock: input device registration failed\n");
+}
+
 /* =========================================================
  * Module Init / Exit
  * ========================================================= */
 
 static int __init my_driver_init(void)
 {
+    struct timespec64 now;
+
+    // 전용 workqueue (IRQ 등록 전에 준비)
+    clock_wq = alloc_workqueue(DEVICE_NAME, WQ_HIGHPRI | (wq_unbound ? WQ_UNBOUND : 0), 0);
+    if (!clock_wq)
+        return -ENOMEM;
+
     // 문자 디바이스 등록
     register_chrdev(DEVICE_MAJOR, DEVICE_NAME, &clock_fops);
 
@@ -319,32 +880,92 @@ static int __init my_driver_init(void)
     // workqueue 초기화
     INIT_WORK(&rotary_work, rotary_work_func);
     INIT_WORK(&btn_work, btn_work_func);
-
-    // 타이머 설정
-    timer_setup(&my_timer, timer_callback, 0);
-    mod_timer(&my_timer, jiffies + msecs_to_jiffies(1000));
+    INIT_DELAYED_WORK(&resync_work, resync_work_func);
+    INIT_DELAYED_WORK(&writeback_work, writeback_work_func);
+    queue_delayed_work(clock_wq, &resync_work,
+                          msecs_to_jiffies(max_t(unsigned int, resync_interval_sec, 1) * 1000));
+
+    // 타이머 설정: 다음 벽시계 초 경계에 해당하는 monotonic 시각에서 첫 만료
+    // _SOFT: 콜백을 기존 timer_list와 같은 softirq에서 실행 (state_lock의 _bh 규칙 유지)
+    ktime_get_real_ts64(&now);
+    hrtimer_init(&tick_timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS_SOFT);
+    tick_timer.function = timer_callback;
+    hrtimer_start(&tick_timer, ktime_add_ns(ktime_get(), NSEC_PER_SEC - now.tv_nsec),
+                  HRTIMER_MODE_ABS_SOFT);
+
+    // evdev 인터페이스 (IRQ 핸들러가 바로 보고하므로 먼저 등록)
+    rot_input_register();
 
     // 인터럽트 등록
+    // 로터리: CLK/DT 양쪽 핀의 상승/하강 에지 모두 (풀 쿼드러처)
+    rot_dec.prev = (gpio_get_value(GPIO_ROT_CLK) << 1) | gpio_get_value(GPIO_ROT_DT);
+    rot_dec.last_detent_ms = ktime_to_ms(ktime_get());
+
     irq_rotary_clk = gpio_to_irq(GPIO_ROT_CLK);
     request_irq(irq_rotary_clk, rotary_irq_handler,
-                IRQF_TRIGGER_FALLING, "rot_clk", NULL);
+                IRQF_TRIGGER_RISING | IRQF_TRIGGER_FALLING, "rot_clk", NULL);
+
+    irq_rotary_dt = gpio_to_irq(GPIO_ROT_DT);
+    request_irq(irq_rotary_dt, rotary_irq_handler,
+                IRQF_TRIGGER_RISING | IRQF_TRIGGER_FALLING, "rot_dt", NULL);
 
     irq_rotary_sw = gpio_to_irq(GPIO_ROT_SW);
     request_irq(irq_rotary_sw, button_irq_handler,
                 IRQF_TRIGGER_FALLING, "rot_sw", NULL);
 
+    // debugfs 통계 (/sys/kernel/debug/smart_clock/)
+    clock_debugfs_dir = debugfs_create_dir(DEVICE_NAME, NULL);
+    debugfs_create_file("stats", 0444, clock_debugfs_dir, NULL, &clock_stats_fops);
+    debugfs_create_file("irq_latency", 0444, clock_debugfs_dir, NULL, &irq_latency_fops);
+
+    // RTC 클래스 디바이스 등록 (실패해도 /dev/smart_clock은 계속 동작)
+    if (platform_driver_register(&ds1302_rtc_driver) == 0) {
+        rtc_pdev = platform_device_register_simple(RTC_DRV_NAME, -1, NULL, 0);
+        if (IS_ERR(rtc_pdev)) {
+            pr_warn("smart_clock: RTC device registration failed\n");
+            platform_driver_unregister(&ds1302_rtc_driver);
+            rtc_pdev = NULL;
+        }
+    }
+
     return 0;
 }
 
 static void __exit my_driver_exit(void)
 {
+    // RTC 클래스 디바이스가 DS1302를 건드리지 않도록 먼저 해제
+    if (rtc_pdev) {
+        platform_device_unregister(rtc_pdev);
+        platform_driver_unregister(&ds1302_rtc_driver);
+    }
+
     unregister_chrdev(DEVICE_MAJOR, DEVICE_NAME);
 
-    del_timer(&my_timer);
+    debugfs_remove_recursive(clock_debugfs_dir);
+
+    hrtimer_cancel(&tick_timer);
 
     free_irq(irq_rotary_clk, NULL);
+    free_irq(irq_rotary_dt, NULL);
     free_irq(irq_rotary_sw, NULL);
 
+    // IRQ 해제 후에 (핸들러가 더 이상 보고하지 않음)
+    if (rot_input)
+        input_unregister_device(rot_input);
+
+    // 남아 있는 work가 GPIO를 건드리기 전에 정리
+    cancel_work_sync(&rotary_work);
+    cancel_work_sync(&btn_work);
+    cancel_delayed_work_sync(&resync_work);
+    cancel_delayed_work_sync(&writeback_work);
+
+    // 설정 중에 언로드되면 바꾼 값을 잃지 않도록 마지막으로 내보냄
+    mutex_lock(&rtc_bus_lock);
+    rtc_flush_pending();
+    mutex_unlock(&rtc_bus_lock);
+
+    destroy_workqueue(clock_wq);
+
     gpio_free(GPIO_RTC_RST);
     gpio_free(GPIO_RTC_CLK);
     gpio_free(GPIO_RTC_DAT);
@@ -0,0 +1,107 @@
+// smart_clock_trace.h
+// rtc_control_driver tracepoint (/sys/kernel/tracing/events/smart_clock/)
+// DS1302 버스 트랜잭션, 엔코더/버튼 IRQ → work 반영, 초 tick을 기록
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM smart_clock
+
+#if !defined(_SMART_CLOCK_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _SMART_CLOCK_TRACE_H
+
+#include <linux/tracepoint.h>
+
+// DS1302 트랜잭션 1회 (CE HIGH~LOW): 명령 바이트, 데이터 바이트 수, 걸린 시간
+// cmd bit0 = 1이면 읽기 (0xBF burst read, 0xBE burst write, 0x8E WP 등)
+TRACE_EVENT(ds1302_xfer,
+    TP_PROTO(u8 cmd, int nbytes, u64 ns),
+    TP_ARGS(cmd, nbytes, ns),
+    TP_STRUCT__entry(
+        __field(u8, cmd)
+        __field(int, nbytes)
+        __field(u64, ns)
+    ),
+    TP_fast_assign(
+        __entry->cmd = cmd;
+        __entry->nbytes = nbytes;
+        __entry->ns = ns;
+    ),
+    TP_printk("cmd=0x%02x %s nbytes=%d ns=%llu", __entry->cmd,
+              (__entry->cmd & 1) ? "read" : "write", __entry->nbytes,
+              (unsigned long long)__entry->ns)
+);
+
+// 엔코더 에지 (하드 IRQ): 핀 상태 (CLK << 1 | DT), 디텐트 판정 결과 (0 = 이동 없음)
+TRACE_EVENT(smart_clock_encoder,
+    TP_PROTO(int state, int step),
+    TP_ARGS(state, step),
+    TP_STRUCT__entry(
+        __field(int, state)
+        __field(int, step)
+    ),
+    TP_fast_assign(
+        __entry->state = state;
+        __entry->step = step;
+    ),
+    TP_printk("state=%d%d step=%d", __entry->state >> 1, __entry->state & 1, __entry->step)
+);
+
+// 버튼 하강 에지 (하드 IRQ): 디바운스 통과 여부
+TRACE_EVENT(smart_clock_button,
+    TP_PROTO(int accepted),
+    TP_ARGS(accepted),
+    TP_STRUCT__entry(
+        __field(int, accepted)
+    ),
+    TP_fast_assign(
+        __entry->accepted = accepted;
+    ),
+    TP_printk("accepted=%d", __entry->accepted)
+);
+
+// work에서 상태 반영 완료: 모드, 반영한 이동량 (버튼이면 0), 반영 후 시각
+TRACE_EVENT(smart_clock_apply,
+    TP_PROTO(int mode, int delta, int hours, int minutes, int seconds),
+    TP_ARGS(mode, delta, hours, minutes, seconds),
+    TP_STRUCT__entry(
+        __field(int, mode)
+        __field(int, delta)
+        __field(int, hours)
+        __field(int, minutes)
+        __field(int, seconds)
+    ),
+    TP_fast_assign(
+        __entry->mode = mode;
+        __entry->delta = delta;
+        __entry->hours = hours;
+        __entry->minutes = minutes;
+        __entry->seconds = seconds;
+    ),
+    TP_printk("mode=%d delta=%d time=%02d:%02d:%02d", __entry->mode, __entry->delta,
+              __entry->hours, __entry->minutes, __entry->seconds)
+);
+
+// 초 경계 hrtimer: hrtimer_forward_now()의 overrun 수, 이번에 1초 진행했는지 여부
+// 진행은 항상 1초씩이고, overruns가 1보다 크면(콜백이 늦었으면) 몇 초를 건너뛰는 대신 DS1302 재동기화를 예약
+TRACE_EVENT(smart_clock_tick,
+    TP_PROTO(u64 overruns, int ticked),
+    TP_ARGS(overruns, ticked),
+    TP_STRUCT__entry(
+        __field(u64, overruns)
+        __field(int, ticked)
+    ),
+    TP_fast_assign(
+        __entry->overruns = overruns;
+        __entry->ticked = ticked;
+    ),
+    TP_printk("overruns=%llu ticked=%d", (unsigned long long)__entry->overruns,
+              __entry->ticked)
+);
+
+#endif /* _SMART_CLOCK_TRACE_H */
+
+// 이 헤더는 드라이버 소스와 같은 디렉터리에 있음 (Makefile: CFLAGS_rtc_control_driver.o := -I$(src))
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE smart_clock_trace
+#include <trace/define_trace.h>